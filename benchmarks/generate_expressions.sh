@@ -0,0 +1,29 @@
+#!/bin/bash
+# Generates an expression-dense MCL script with the requested number of
+# statements (default 200,000) for parser benchmarks. Every statement mixes
+# operators from all precedence levels with unary operators and parentheses.
+# Usage: benchmarks/generate_expressions.sh [count] > /tmp/expressions.mcl
+
+count=${1:-200000}
+
+awk -v n="$count" 'BEGIN {
+    print "integer $a = 7;"
+    print "integer $b = 3;"
+    print "number $x = 1.5;"
+    print "boolean $flag = false;"
+    print "string $text = \"\";"
+    for (i = 5; i < n; i++) {
+        kind = i % 5;
+        if (kind == 0)
+            printf "$a = ($a + $b * %d - ($b - %d) / 2) * 3 - $a * 2 - %d;\n", i % 7 + 1, i % 11, i % 13;
+        else if (kind == 1)
+            printf "$flag = $a + 1 > $b * 2 and $b <= %d or not ($a == $b) and -$b < %d;\n", i % 50, i % 9;
+        else if (kind == 2)
+            printf "$x = -($x * 0.5 + %d.25) / (2.0 + $b * $b) + $a / (%d + 1.5) - $x / 4;\n", i % 31, i % 17;
+        else if (kind == 3)
+            printf "$text = \"v\" . ($a + %d) . \"-\" . ($b * 2 - 1) . ($a >= $b) . \"!\";\n", i % 23;
+        else
+            printf "$b = (($b | %d) + ($b | 1) * (%d - 2) - ((($b + 1) * 2) / 4)) / 8 + 3;\n", i % 64, i % 5;
+    }
+    print "echo $a . \" \" . $b . \" \" . $x . \" \" . $flag . \" \" . $text;"
+}'
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Generates an MCL script that declares a library of functions (default 2,000)
+# and calls only a handful of them, for measuring --lazy-functions.
+# Usage: benchmarks/generate_library.sh [functions] > /tmp/library.mcl
+
+count=${1:-2000}
+
+awk -v n="$count" 'BEGIN {
+    for (i = 0; i < n; i++) {
+        printf "function helper_%d(integer $value, string $tag = \"h%d\"): string\n", i, i
+        print "{"
+        print "    integer $doubled = $value * 2 + 1;"
+        print "    integer $mixed = ($doubled - $value) * 3 + ($value / 2);"
+        print "    string $text = $tag . \"-\" . $doubled . \"-\" . $mixed;"
+        print "    string $padded = uppercase($text) . reverse($tag);"
+        print "    return $padded . \":\" . ($mixed + $doubled);"
+        print "}"
+    }
+    for (i = 0; i < 5; i++) {
+        printf "echo helper_%d(%d);\n", i * 7, i
+    }
+}'
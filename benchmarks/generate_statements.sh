@@ -0,0 +1,28 @@
+#!/bin/bash
+# Generates a straight-line MCL script with the requested number of statements
+# (default 1,000,000) for front-end benchmarks.
+# Usage: benchmarks/generate_statements.sh [count] > /tmp/large.mcl
+
+count=${1:-1000000}
+
+awk -v n="$count" 'BEGIN {
+    print "function scale(integer $value, integer $factor = 3): integer"
+    print "{"
+    print "    integer $scaled = $value * $factor;"
+    print "    return $scaled + 1;"
+    print "}"
+    print "integer $total = 0;"
+    print "string $label = \"start\";"
+    for (i = 3; i < n; i++) {
+        kind = i % 4;
+        if (kind == 0)
+            printf "$v%d = %d * 2 + $total;\n", i % 1000, i;
+        else if (kind == 1)
+            printf "$total = $total + %d - (%d - 1);\n", i, i;
+        else if (kind == 2)
+            printf "$label = \"item-\" . %d . \"-\" . $total;\n", i;
+        else
+            printf "$total = scale(%d) - scale($total, 1) + %d; // generated\n", i % 97, i;
+    }
+    print "echo $label;"
+}'
@@ -0,0 +1,516 @@
+#include "type_checker.h"
+#include "../runtime/evaluator.h"
+#include <variant>
+
+static constexpr TypeSet STRING_TYPE = 1 << 0;
+static constexpr TypeSet INTEGER_TYPE = 1 << 1;
+static constexpr TypeSet NUMBER_TYPE = 1 << 2;
+static constexpr TypeSet BOOLEAN_TYPE = 1 << 3;
+static constexpr TypeSet NULL_TYPE = 1 << 4;
+static constexpr TypeSet INTEGRAL_TYPES = INTEGER_TYPE | BOOLEAN_TYPE;
+static constexpr TypeSet NUMERIC_TYPES = INTEGRAL_TYPES | NUMBER_TYPE;
+static constexpr TypeSet ANY_TYPE = STRING_TYPE | NUMERIC_TYPES | NULL_TYPE;
+
+static TypeSet typeOfValue(const Value &value)
+{
+    return static_cast<TypeSet>(1u << value.index());
+}
+
+static uint8_t declaredBit(DeclaredType type)
+{
+    return static_cast<uint8_t>(1u << static_cast<unsigned>(type));
+}
+
+static TypeSet accepted(DeclaredType type, TypeSet types)
+{
+    switch (type)
+    {
+    case DeclaredType::STRING:
+        return types & STRING_TYPE;
+    case DeclaredType::INTEGER:
+        return types & NUMERIC_TYPES;
+    case DeclaredType::NUMBER:
+        return (types & (NUMBER_TYPE | BOOLEAN_TYPE)) | ((types & INTEGER_TYPE) ? NUMBER_TYPE : 0);
+    case DeclaredType::BOOLEAN:
+        return (types & BOOLEAN_TYPE) | ((types & INTEGER_TYPE) ? BOOLEAN_TYPE : 0);
+    default:
+        return types;
+    }
+}
+
+static TypeSet passesUnchanged(DeclaredType type)
+{
+    switch (type)
+    {
+    case DeclaredType::STRING:
+        return STRING_TYPE;
+    case DeclaredType::INTEGER:
+        return INTEGRAL_TYPES;
+    case DeclaredType::NUMBER:
+        return NUMBER_TYPE | BOOLEAN_TYPE;
+    case DeclaredType::BOOLEAN:
+        return BOOLEAN_TYPE;
+    default:
+        return ANY_TYPE;
+    }
+}
+
+static bool conforms(DeclaredType type, TypeSet types)
+{
+    return (types & ~passesUnchanged(type)) == 0;
+}
+
+static bool conformsToAll(uint8_t declared, TypeSet types)
+{
+    for (DeclaredType type : {DeclaredType::STRING, DeclaredType::INTEGER, DeclaredType::NUMBER, DeclaredType::BOOLEAN})
+    {
+        if ((declared & declaredBit(type)) && !conforms(type, types))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static TypeSet arithmeticResult(TypeSet left, TypeSet right)
+{
+    TypeSet result = 0;
+    if ((left & INTEGRAL_TYPES) && (right & INTEGRAL_TYPES))
+    {
+        result |= INTEGER_TYPE | NUMBER_TYPE;
+    }
+    if (((left & NUMBER_TYPE) && (right & NUMERIC_TYPES)) || ((right & NUMBER_TYPE) && (left & NUMERIC_TYPES)))
+    {
+        result |= NUMBER_TYPE;
+    }
+    return result;
+}
+
+TypeChecker::TypeChecker(Evaluator &evaluator)
+    : evaluator(evaluator), current(nullptr), deferredFunctions(0), changed(false), annotating(false) {}
+
+void TypeChecker::check(ProgramNode *program)
+{
+    const std::vector<VariableSlot> &globals = evaluator.globals;
+    globalValues.assign(globals.size(), 0);
+    globalDeclared.assign(globals.size(), declaredBit(DeclaredType::ANY));
+    for (size_t slot = 0; slot < globals.size(); ++slot)
+    {
+        if (globals[slot].defined)
+        {
+            globalValues[slot] = typeOfValue(globals[slot].value);
+            globalDeclared[slot] |= declaredBit(globals[slot].type);
+        }
+    }
+
+    untrackedSymbols.assign(program->symbols.size(), false);
+    callees.assign(evaluator.functions.size(), nullptr);
+    ambiguousCallees.assign(evaluator.functions.size(), false);
+    functionTypes.clear();
+    deferredFunctions = 0;
+    current = nullptr;
+
+    for (const auto &stmt : program->statements)
+    {
+        collect(stmt);
+    }
+    for (auto &[function, types] : functionTypes)
+    {
+        types.exact_parameters = deferredFunctions == 0 && knownCallee(function->function_slot) == function;
+    }
+
+    annotating = false;
+    do
+    {
+        changed = false;
+        for (const auto &stmt : program->statements)
+        {
+            visitStatement(stmt);
+        }
+    } while (changed);
+
+    annotating = true;
+    for (const auto &stmt : program->statements)
+    {
+        visitStatement(stmt);
+    }
+    annotating = false;
+}
+
+void TypeChecker::checkFunction(FunctionDeclaration *function)
+{
+    if (deferredFunctions > 0)
+    {
+        --deferredFunctions;
+    }
+    current = nullptr;
+    collect(function);
+
+    do
+    {
+        changed = false;
+        visitFunction(function);
+    } while (changed);
+
+    annotating = true;
+    visitFunction(function);
+    annotating = false;
+}
+
+void TypeChecker::collect(ASTNode *node)
+{
+    switch (node->kind)
+    {
+    case NodeKind::FUNCTION_DECLARATION:
+    {
+        auto *funcDecl = static_cast<FunctionDeclaration *>(node);
+        registerCallee(funcDecl);
+        if (!funcDecl->body)
+        {
+            ++deferredFunctions;
+            for (Symbol symbol : funcDecl->deferred_writes)
+            {
+                untrack(symbol);
+            }
+            break;
+        }
+
+        FunctionTypes &types = functionTypes[funcDecl];
+        types.values.assign(funcDecl->local_symbols.size(), 0);
+        types.declared.assign(funcDecl->local_symbols.size(), declaredBit(DeclaredType::ANY));
+        types.returns = 0;
+
+        FunctionTypes *enclosing = current;
+        current = &types;
+        for (size_t i = 0; i < funcDecl->parameters.size(); ++i)
+        {
+            types.declared[funcDecl->parameters[i].slot] |= declaredBit(funcDecl->signature.parameter_types[i]);
+        }
+        for (const auto &stmt : funcDecl->body->statements)
+        {
+            collect(stmt);
+        }
+        current = enclosing;
+        break;
+    }
+    case NodeKind::BLOCK_STATEMENT:
+        for (const auto &stmt : static_cast<BlockStatement *>(node)->statements)
+        {
+            collect(stmt);
+        }
+        break;
+    case NodeKind::DECLARATION_STATEMENT:
+    {
+        auto *decl = static_cast<DeclarationStatement *>(node);
+        declaredOf(decl->target) |= declaredBit(tokenTypeToDeclaredType(decl->declared_type));
+        break;
+    }
+    case NodeKind::ASSIGNMENT_STATEMENT:
+    {
+        auto *assign = static_cast<AssignmentStatement *>(node);
+        if (assign->target->scope == VariableScope::DYNAMIC)
+        {
+            untrack(assign->target->symbol);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void TypeChecker::untrack(Symbol symbol)
+{
+    if (symbol >= untrackedSymbols.size())
+    {
+        untrackedSymbols.resize(symbol + 1, false);
+    }
+    untrackedSymbols[symbol] = true;
+}
+
+void TypeChecker::registerCallee(FunctionDeclaration *function)
+{
+    uint32_t slot = function->function_slot;
+    if (slot >= callees.size())
+    {
+        callees.resize(slot + 1, nullptr);
+        ambiguousCallees.resize(slot + 1, false);
+    }
+    if (callees[slot] == nullptr)
+    {
+        callees[slot] = function;
+    }
+    else if (callees[slot] != function)
+    {
+        ambiguousCallees[slot] = true;
+    }
+}
+
+FunctionDeclaration *TypeChecker::knownCallee(uint32_t function_slot) const
+{
+    if (function_slot >= callees.size() || ambiguousCallees[function_slot] ||
+        (function_slot < evaluator.functions.size() && evaluator.functions[function_slot].native))
+    {
+        return nullptr;
+    }
+    return callees[function_slot];
+}
+
+void TypeChecker::visitStatement(ASTNode *node)
+{
+    switch (node->kind)
+    {
+    case NodeKind::FUNCTION_DECLARATION:
+        visitFunction(static_cast<FunctionDeclaration *>(node));
+        break;
+    case NodeKind::BLOCK_STATEMENT:
+        for (const auto &stmt : static_cast<BlockStatement *>(node)->statements)
+        {
+            visitStatement(stmt);
+        }
+        break;
+    case NodeKind::RETURN_STATEMENT:
+    {
+        auto *ret = static_cast<ReturnStatement *>(node);
+        TypeSet types = ret->expression ? typeOf(ret->expression) : NULL_TYPE;
+        if (current)
+        {
+            merge(current->returns, types);
+        }
+        break;
+    }
+    case NodeKind::DECLARATION_STATEMENT:
+    {
+        auto *decl = static_cast<DeclarationStatement *>(node);
+        DeclaredType declared_type = tokenTypeToDeclaredType(decl->declared_type);
+        TypeSet types = decl->value ? typeOf(decl->value) : typeOfValue(defaultValueForTypeKeyword(decl->declared_type));
+        merge(valuesOf(decl->target), accepted(declared_type, types));
+        record(decl->needs_type_check, conforms(declared_type, types));
+        break;
+    }
+    case NodeKind::ASSIGNMENT_STATEMENT:
+    {
+        auto *assign = static_cast<AssignmentStatement *>(node);
+        TypeSet types = typeOf(assign->value);
+        if (assign->target->scope == VariableScope::DYNAMIC)
+        {
+            record(assign->needs_type_check, false);
+            break;
+        }
+        uint8_t declared = declaredOf(assign->target);
+        TypeSet widened = 0;
+        if (types & INTEGER_TYPE)
+        {
+            widened |= (declared & declaredBit(DeclaredType::NUMBER)) ? NUMBER_TYPE : 0;
+            widened |= (declared & declaredBit(DeclaredType::BOOLEAN)) ? BOOLEAN_TYPE : 0;
+        }
+        merge(valuesOf(assign->target), types | widened);
+        record(assign->needs_type_check, conformsToAll(declared, types));
+        break;
+    }
+    case NodeKind::ECHO_STATEMENT:
+        typeOf(static_cast<EchoStatement *>(node)->expression);
+        break;
+    default:
+        typeOf(node);
+        break;
+    }
+}
+
+void TypeChecker::visitFunction(FunctionDeclaration *node)
+{
+    if (!node->body)
+    {
+        return;
+    }
+
+    FunctionTypes &types = functionTypes[node];
+    FunctionTypes *enclosing = current;
+    current = &types;
+
+    for (size_t i = 0; i < node->parameters.size(); ++i)
+    {
+        ParameterDeclaration &param = node->parameters[i];
+        DeclaredType param_type = node->signature.parameter_types[i];
+        if (param.default_value)
+        {
+            TypeSet defaults = typeOf(param.default_value);
+            merge(types.values[param.slot], accepted(param_type, defaults));
+            record(param.default_needs_check, conforms(param_type, defaults));
+        }
+        if (!types.exact_parameters)
+        {
+            merge(types.values[param.slot], accepted(param_type, ANY_TYPE));
+        }
+    }
+
+    for (const auto &stmt : node->body->statements)
+    {
+        visitStatement(stmt);
+    }
+
+    merge(types.returns, typeOfValue(defaultValueForTypeKeyword(node->return_type)));
+    record(node->return_needs_check, conforms(node->signature.return_type, types.returns));
+    current = enclosing;
+}
+
+TypeSet TypeChecker::typeOf(ASTNode *node)
+{
+    if (!node)
+    {
+        return NULL_TYPE;
+    }
+
+    switch (node->kind)
+    {
+    case NodeKind::STRING_LITERAL:
+        return STRING_TYPE;
+    case NodeKind::INTEGER_LITERAL:
+        return INTEGER_TYPE;
+    case NodeKind::NUMBER_LITERAL:
+        return NUMBER_TYPE;
+    case NodeKind::BOOLEAN_LITERAL:
+        return BOOLEAN_TYPE;
+    case NodeKind::VARIABLE:
+        return typeOfVariable(static_cast<VariableExpr *>(node));
+    case NodeKind::CALL:
+        return typeOfCall(static_cast<CallExpr *>(node));
+    case NodeKind::UNARY_OP:
+    {
+        auto *unaryOp = static_cast<UnaryOpExpr *>(node);
+        TypeSet right = typeOf(unaryOp->right);
+        switch (unaryOp->op)
+        {
+        case TokenType::MINUS:
+            return ((right & INTEGRAL_TYPES) ? INTEGER_TYPE | NUMBER_TYPE : 0) | (right & NUMBER_TYPE);
+        case TokenType::BANG:
+        case TokenType::NOT:
+            return BOOLEAN_TYPE;
+        default:
+            return ANY_TYPE;
+        }
+    }
+    case NodeKind::BINARY_OP:
+    {
+        auto *binOp = static_cast<BinaryOpExpr *>(node);
+        TypeSet left = typeOf(binOp->left);
+        TypeSet right = typeOf(binOp->right);
+        switch (binOp->op)
+        {
+        case TokenType::DOT:
+            return STRING_TYPE;
+        case TokenType::PLUS:
+        case TokenType::MINUS:
+        case TokenType::STAR:
+        case TokenType::SLASH:
+            return arithmeticResult(left, right);
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQUAL:
+        case TokenType::LESS:
+        case TokenType::LESS_EQUAL:
+        case TokenType::EQUAL_EQUAL:
+        case TokenType::BANG_EQUAL:
+        case TokenType::AND:
+        case TokenType::OR:
+            return BOOLEAN_TYPE;
+        case TokenType::PIPE:
+            return INTEGER_TYPE;
+        default:
+            return ANY_TYPE;
+        }
+    }
+    default:
+        return ANY_TYPE;
+    }
+}
+
+TypeSet TypeChecker::typeOfVariable(VariableExpr *var) const
+{
+    if (var->symbol < untrackedSymbols.size() && untrackedSymbols[var->symbol])
+    {
+        return ANY_TYPE;
+    }
+
+    switch (var->scope)
+    {
+    case VariableScope::GLOBAL:
+        return globalValues[var->slot];
+    case VariableScope::LOCAL:
+        return current->values[var->slot];
+    default:
+        return ANY_TYPE;
+    }
+}
+
+TypeSet TypeChecker::typeOfCall(CallExpr *node)
+{
+    uint32_t slot = node->function_slot;
+    FunctionDeclaration *callee = slot == CallExpr::UNBOUND ? nullptr : knownCallee(slot);
+    FunctionTypes *callee_types = nullptr;
+    if (callee && callee->body)
+    {
+        auto it = functionTypes.find(callee);
+        callee_types = it != functionTypes.end() ? &it->second : nullptr;
+    }
+
+    bool elided = callee && deferredFunctions == 0;
+    for (size_t i = 0; i < node->arguments.size(); ++i)
+    {
+        TypeSet types = typeOf(node->arguments[i]);
+        if (!callee || i >= callee->parameters.size())
+        {
+            continue;
+        }
+        DeclaredType param_type = callee->signature.parameter_types[i];
+        elided = elided && conforms(param_type, types);
+        if (callee_types && callee_types->exact_parameters)
+        {
+            merge(callee_types->values[callee->parameters[i].slot], accepted(param_type, types));
+        }
+    }
+
+    bool native = slot < evaluator.functions.size() && evaluator.functions[slot].native;
+    if (slot != CallExpr::UNBOUND && !native && !node->arguments.empty())
+    {
+        record(node->arguments_need_check, elided, node->arguments.size());
+    }
+
+    if (!callee)
+    {
+        return ANY_TYPE;
+    }
+    return accepted(callee->signature.return_type, callee_types ? callee_types->returns : ANY_TYPE);
+}
+
+TypeSet &TypeChecker::valuesOf(VariableExpr *var)
+{
+    return var->scope == VariableScope::LOCAL ? current->values[var->slot] : globalValues[var->slot];
+}
+
+uint8_t &TypeChecker::declaredOf(VariableExpr *var)
+{
+    return var->scope == VariableScope::LOCAL ? current->declared[var->slot] : globalDeclared[var->slot];
+}
+
+void TypeChecker::merge(TypeSet &target, TypeSet types)
+{
+    if ((target | types) != target)
+    {
+        target |= types;
+        changed = true;
+    }
+}
+
+void TypeChecker::record(bool &needs_check, bool elided, size_t sites)
+{
+    if (!annotating)
+    {
+        return;
+    }
+    needs_check = !elided;
+    evaluator.stats.type_checks += sites;
+    if (elided)
+    {
+        evaluator.stats.type_checks_elided += sites;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef TYPE_CHECKER_H
+#define TYPE_CHECKER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../parser/ast.h"
+
+class Evaluator;
+
+using TypeSet = uint8_t;
+
+class TypeChecker
+{
+private:
+    struct FunctionTypes
+    {
+        std::vector<TypeSet> values;
+        std::vector<uint8_t> declared;
+        TypeSet returns = 0;
+        bool exact_parameters = false;
+    };
+
+    Evaluator &evaluator;
+    std::vector<TypeSet> globalValues;
+    std::vector<uint8_t> globalDeclared;
+    std::vector<bool> untrackedSymbols;
+    std::vector<FunctionDeclaration *> callees;
+    std::vector<bool> ambiguousCallees;
+    std::unordered_map<FunctionDeclaration *, FunctionTypes> functionTypes;
+    FunctionTypes *current;
+    size_t deferredFunctions;
+    bool changed;
+    bool annotating;
+
+    void collect(ASTNode *node);
+    void untrack(Symbol symbol);
+    void registerCallee(FunctionDeclaration *function);
+    FunctionDeclaration *knownCallee(uint32_t function_slot) const;
+
+    void visitStatement(ASTNode *node);
+    void visitFunction(FunctionDeclaration *node);
+    TypeSet typeOf(ASTNode *node);
+    TypeSet typeOfVariable(VariableExpr *var) const;
+    TypeSet typeOfCall(CallExpr *node);
+
+    TypeSet &valuesOf(VariableExpr *var);
+    uint8_t &declaredOf(VariableExpr *var);
+    void merge(TypeSet &target, TypeSet types);
+    void record(bool &needs_check, bool elided, size_t sites = 1);
+
+public:
+    TypeChecker(Evaluator &evaluator);
+
+    void check(ProgramNode *program);
+    void checkFunction(FunctionDeclaration *function);
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include "source_buffer.h"
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceBuffer::~SourceBuffer()
+{
+    if (mapping)
+    {
+        munmap(mapping, length);
+    }
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::open(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<SourceBuffer> buffer(new SourceBuffer());
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        void *mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            madvise(mapped, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            buffer->mapping = mapped;
+            buffer->data = static_cast<const char *>(mapped);
+            buffer->length = static_cast<size_t>(info.st_size);
+            close(fd);
+            return buffer;
+        }
+    }
+    close(fd);
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return nullptr;
+    }
+    buffer->owned.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    buffer->data = buffer->owned.data();
+    buffer->length = buffer->owned.size();
+    return buffer;
+}
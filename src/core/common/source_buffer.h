@@ -0,0 +1,29 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class SourceBuffer
+{
+private:
+    const char *data = nullptr;
+    size_t length = 0;
+    void *mapping = nullptr;
+    std::string owned;
+
+    SourceBuffer() = default;
+
+public:
+    SourceBuffer(const SourceBuffer &) = delete;
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+    ~SourceBuffer();
+
+    static std::unique_ptr<SourceBuffer> open(const std::string &path);
+
+    std::string_view text() const { return std::string_view(data, length); }
+};
+
+#endif
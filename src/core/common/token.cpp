@@ -49,13 +49,9 @@ static const std::map<TokenType, std::string> tokenTypeNames = {
 std::string Token::toString() const
 {
     std::string typeName = tokenTypeNames.count(type) ? tokenTypeNames.at(type) : "UNKNOWN_TYPE";
-    std::string str = typeName + " (\"" + lexeme + "\")";
+    std::string str = typeName + " (\"" + std::string(lexeme) + "\")";
 
-    if (std::holds_alternative<std::string>(literal))
-    {
-        str += " -> \"" + std::get<std::string>(literal) + "\"";
-    }
-    else if (std::holds_alternative<long long>(literal))
+    if (std::holds_alternative<long long>(literal))
     {
         str += " -> " + std::to_string(std::get<long long>(literal));
     }
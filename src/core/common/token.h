@@ -2,6 +2,7 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <variant>
 #include <utility>
 #include <cstdint>
@@ -74,18 +75,37 @@ inline DeclaredType tokenTypeToDeclaredType(TokenType type)
     }
 }
 
+inline Value defaultValueForTypeKeyword(TokenType type)
+{
+    switch (type)
+    {
+    case TokenType::STRING_KEYWORD:
+        return std::string("");
+    case TokenType::INTEGER_KEYWORD:
+        return 0LL;
+    case TokenType::NUMBER_KEYWORD:
+        return 0.0;
+    case TokenType::BOOLEAN_KEYWORD:
+        return false;
+    default:
+        return std::monostate{};
+    }
+}
+
+using TokenLiteral = std::variant<std::monostate, long long, double, bool>;
+
 struct Token
 {
     TokenType type;
-    std::string lexeme;
-    std::variant<std::string, long long, double, bool, std::monostate> literal;
+    std::string_view lexeme;
+    TokenLiteral literal;
     int line;
 
-    Token(TokenType type, std::string lexeme, std::variant<std::string, long long, double, bool, std::monostate> literal, int line)
-        : type(type), lexeme(std::move(lexeme)), literal(std::move(literal)), line(line) {}
+    Token(TokenType type, std::string_view lexeme, TokenLiteral literal, int line)
+        : type(type), lexeme(lexeme), literal(literal), line(line) {}
 
-    Token(TokenType type, std::string lexeme, int line)
-        : type(type), lexeme(std::move(lexeme)), literal(std::monostate{}), line(line) {}
+    Token(TokenType type, std::string_view lexeme, int line)
+        : type(type), lexeme(lexeme), literal(std::monostate{}), line(line) {}
 
     std::string toString() const;
 };
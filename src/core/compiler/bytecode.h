@@ -0,0 +1,136 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include "../common/value.h"
+#include "../parser/interner.h"
+
+enum class OpCode : uint8_t
+{
+    CONSTANT,
+    POP,
+
+    GET_GLOBAL,
+    SET_GLOBAL,
+    SET_GLOBAL_UNCHECKED,
+    DECLARE_GLOBAL,
+    DECLARE_GLOBAL_UNCHECKED,
+    GET_LOCAL,
+    SET_LOCAL,
+    SET_LOCAL_UNCHECKED,
+    DECLARE_LOCAL,
+    DECLARE_LOCAL_UNCHECKED,
+    GET_DYNAMIC,
+    SET_DYNAMIC,
+
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    GREATER,
+    GREATER_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    EQUAL,
+    NOT_EQUAL,
+    AND,
+    OR,
+    BIT_OR,
+    CONCAT,
+
+    NEGATE,
+    NOT,
+
+    ECHO,
+    CALL,
+    CALL_UNCHECKED,
+    DEFINE_FUNCTION,
+    PARAM,
+    BIND_DEFAULT,
+    RETURN,
+
+    RUNTIME_ERROR,
+    HALT,
+};
+
+struct Chunk
+{
+    std::vector<uint8_t> code;
+    std::vector<Value> constants;
+    std::vector<std::string> names;
+    std::vector<Symbol> name_symbols;
+
+    void write(OpCode op) { code.push_back(static_cast<uint8_t>(op)); }
+    void writeByte(uint8_t byte) { code.push_back(byte); }
+
+    void writeU16(uint16_t value)
+    {
+        code.push_back(static_cast<uint8_t>(value & 0xFF));
+        code.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void writeU32(uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            code.push_back(static_cast<uint8_t>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void patchU16(size_t offset, uint16_t value)
+    {
+        code[offset] = static_cast<uint8_t>(value & 0xFF);
+        code[offset + 1] = static_cast<uint8_t>(value >> 8);
+    }
+};
+
+inline uint16_t readU16(const uint8_t *ip)
+{
+    return static_cast<uint16_t>(ip[0] | (ip[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t *ip)
+{
+    return static_cast<uint32_t>(ip[0]) | (static_cast<uint32_t>(ip[1]) << 8) |
+           (static_cast<uint32_t>(ip[2]) << 16) | (static_cast<uint32_t>(ip[3]) << 24);
+}
+
+struct FunctionDeclaration;
+
+struct ParameterProto
+{
+    std::string name;
+    DeclaredType declared_type;
+    bool has_default;
+    bool check_default;
+    uint16_t slot;
+};
+
+struct FunctionProto
+{
+    std::string name;
+    uint32_t slot;
+    std::vector<ParameterProto> parameters;
+    DeclaredType return_type;
+    bool check_return = true;
+    Value default_return_value;
+    std::vector<std::string> local_names;
+    std::vector<Symbol> local_symbols;
+    Chunk chunk;
+    FunctionDeclaration *deferred = nullptr;
+};
+
+struct CompiledProgram
+{
+    Chunk main;
+    std::vector<std::unique_ptr<FunctionProto>> functions;
+    std::vector<std::string> global_names;
+    std::vector<std::string> function_names;
+    size_t type_checks = 0;
+    size_t type_checks_elided = 0;
+};
+
+#endif
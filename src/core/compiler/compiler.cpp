@@ -0,0 +1,425 @@
+#include "compiler.h"
+#include "../common/token.h"
+#include <stdexcept>
+#include <string>
+#include <limits>
+
+Compiler::Compiler(const Interner &symbols) : symbols(symbols), program(nullptr), chunk(nullptr) {}
+
+std::unique_ptr<CompiledProgram> Compiler::compile(ProgramNode *node)
+{
+    auto compiled = std::make_unique<CompiledProgram>();
+    program = compiled.get();
+    beginChunk(&compiled->main);
+
+    for (const auto &stmt : node->statements)
+    {
+        compileStatement(stmt);
+    }
+    chunk->write(OpCode::HALT);
+
+    program = nullptr;
+    chunk = nullptr;
+    return compiled;
+}
+
+void Compiler::beginChunk(Chunk *target)
+{
+    chunk = target;
+    stringConstants.clear();
+    integerConstants.clear();
+    nameIndices.clear();
+}
+
+uint32_t Compiler::addConstant(const Value &value)
+{
+    if (std::holds_alternative<std::string>(value))
+    {
+        auto it = stringConstants.find(std::get<std::string>(value));
+        if (it != stringConstants.end())
+        {
+            return it->second;
+        }
+        uint32_t index = static_cast<uint32_t>(chunk->constants.size());
+        stringConstants.emplace(std::get<std::string>(value), index);
+        chunk->constants.push_back(value);
+        return index;
+    }
+    if (std::holds_alternative<long long>(value))
+    {
+        auto it = integerConstants.find(std::get<long long>(value));
+        if (it != integerConstants.end())
+        {
+            return it->second;
+        }
+        uint32_t index = static_cast<uint32_t>(chunk->constants.size());
+        integerConstants.emplace(std::get<long long>(value), index);
+        chunk->constants.push_back(value);
+        return index;
+    }
+
+    chunk->constants.push_back(value);
+    return static_cast<uint32_t>(chunk->constants.size() - 1);
+}
+
+uint32_t Compiler::addName(Symbol symbol, std::string_view name)
+{
+    auto it = nameIndices.find(symbol);
+    if (it != nameIndices.end())
+    {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(chunk->names.size());
+    chunk->names.emplace_back(name);
+    chunk->name_symbols.push_back(symbol);
+    nameIndices.emplace(symbol, index);
+    return index;
+}
+
+void Compiler::emitConstant(const Value &value)
+{
+    chunk->write(OpCode::CONSTANT);
+    chunk->writeU32(addConstant(value));
+}
+
+void Compiler::emitNameOp(OpCode op, Symbol symbol, std::string_view name)
+{
+    chunk->write(op);
+    chunk->writeU32(addName(symbol, name));
+}
+
+void Compiler::emitVariableOp(OpCode global_op, OpCode local_op, VariableExpr *var)
+{
+    switch (var->scope)
+    {
+    case VariableScope::GLOBAL:
+        chunk->write(global_op);
+        chunk->writeU32(var->slot);
+        break;
+    case VariableScope::LOCAL:
+        chunk->write(local_op);
+        chunk->writeU16(static_cast<uint16_t>(var->slot));
+        break;
+    case VariableScope::DYNAMIC:
+        if (global_op == OpCode::GET_GLOBAL)
+        {
+            emitNameOp(OpCode::GET_DYNAMIC, var->symbol, var->name);
+        }
+        else if (global_op == OpCode::SET_GLOBAL || global_op == OpCode::SET_GLOBAL_UNCHECKED)
+        {
+            emitNameOp(OpCode::SET_DYNAMIC, var->symbol, var->name);
+            chunk->writeU16(static_cast<uint16_t>(var->slot));
+        }
+        else
+        {
+            throw std::runtime_error("Internal error: Variable '" + std::string(var->name) + "' cannot be declared dynamically.");
+        }
+        break;
+    default:
+        throw std::runtime_error("Internal error: Variable '" + std::string(var->name) + "' was not resolved before compilation.");
+    }
+}
+
+void Compiler::emitRuntimeError(const std::string &message)
+{
+    chunk->write(OpCode::RUNTIME_ERROR);
+    chunk->writeU32(addConstant(message));
+}
+
+void Compiler::compileStatement(ASTNode *node)
+{
+    switch (node->kind)
+    {
+    case NodeKind::FUNCTION_DECLARATION:
+        compileFunctionDeclaration(static_cast<FunctionDeclaration *>(node));
+        break;
+    case NodeKind::BLOCK_STATEMENT:
+        for (const auto &stmt : static_cast<BlockStatement *>(node)->statements)
+        {
+            compileStatement(stmt);
+        }
+        break;
+    case NodeKind::RETURN_STATEMENT:
+        compileReturnStatement(static_cast<ReturnStatement *>(node));
+        break;
+    case NodeKind::DECLARATION_STATEMENT:
+        compileDeclarationStatement(static_cast<DeclarationStatement *>(node));
+        break;
+    case NodeKind::ASSIGNMENT_STATEMENT:
+        compileAssignmentStatement(static_cast<AssignmentStatement *>(node));
+        break;
+    case NodeKind::ECHO_STATEMENT:
+        compileExpression(static_cast<EchoStatement *>(node)->expression);
+        chunk->write(OpCode::ECHO);
+        break;
+    default:
+        compileExpression(node);
+        chunk->write(OpCode::POP);
+        break;
+    }
+}
+
+void Compiler::compileExpression(ASTNode *node)
+{
+    if (!node)
+    {
+        emitConstant(std::monostate{});
+        return;
+    }
+
+    switch (node->kind)
+    {
+    case NodeKind::STRING_LITERAL:
+        emitConstant(std::string(static_cast<StringLiteralExpr *>(node)->value));
+        break;
+    case NodeKind::INTEGER_LITERAL:
+        emitConstant(static_cast<IntegerLiteralExpr *>(node)->value);
+        break;
+    case NodeKind::NUMBER_LITERAL:
+        emitConstant(static_cast<NumberLiteralExpr *>(node)->value);
+        break;
+    case NodeKind::BOOLEAN_LITERAL:
+        emitConstant(static_cast<BooleanLiteralExpr *>(node)->value);
+        break;
+    case NodeKind::VARIABLE:
+        emitVariableOp(OpCode::GET_GLOBAL, OpCode::GET_LOCAL, static_cast<VariableExpr *>(node));
+        break;
+    case NodeKind::BINARY_OP:
+        compileBinaryOpExpr(static_cast<BinaryOpExpr *>(node));
+        break;
+    case NodeKind::UNARY_OP:
+        compileUnaryOpExpr(static_cast<UnaryOpExpr *>(node));
+        break;
+    case NodeKind::CALL:
+        compileCallExpr(static_cast<CallExpr *>(node));
+        break;
+    default:
+        throw std::runtime_error("Unknown AST node type during compilation.");
+    }
+}
+
+void Compiler::compileFunctionDeclaration(FunctionDeclaration *node)
+{
+    auto proto = std::make_unique<FunctionProto>();
+    proto->name = node->name;
+    proto->slot = node->function_slot;
+    proto->return_type = node->signature.return_type;
+    proto->default_return_value = defaultValueForTypeKeyword(node->return_type);
+
+    if (node->body)
+    {
+        compileFunctionBody(node, proto.get());
+    }
+    else
+    {
+        proto->deferred = node;
+    }
+
+    uint32_t function_index = static_cast<uint32_t>(program->functions.size());
+    program->functions.push_back(std::move(proto));
+    chunk->write(OpCode::DEFINE_FUNCTION);
+    chunk->writeU32(function_index);
+}
+
+void Compiler::compileFunctionBody(FunctionDeclaration *node, FunctionProto *proto)
+{
+    if (node->parameters.size() > std::numeric_limits<uint8_t>::max())
+    {
+        throw std::runtime_error("Compile error: Function '" + std::string(node->name) + "' declares too many parameters.");
+    }
+    if (node->local_symbols.size() > std::numeric_limits<uint16_t>::max())
+    {
+        throw std::runtime_error("Compile error: Function '" + std::string(node->name) + "' declares too many local variables.");
+    }
+
+    proto->deferred = nullptr;
+    proto->check_return = node->return_needs_check;
+    proto->local_symbols.assign(node->local_symbols.begin(), node->local_symbols.end());
+    proto->local_names.clear();
+    for (Symbol symbol : node->local_symbols)
+    {
+        proto->local_names.emplace_back(symbols.name(symbol));
+    }
+
+    Chunk *enclosing = chunk;
+    auto saved_strings = std::move(stringConstants);
+    auto saved_integers = std::move(integerConstants);
+    auto saved_names = std::move(nameIndices);
+    beginChunk(&proto->chunk);
+
+    for (size_t i = 0; i < node->parameters.size(); ++i)
+    {
+        const ParameterDeclaration &param = node->parameters[i];
+        proto->parameters.push_back({std::string(param.name), node->signature.parameter_types[i], param.default_value != nullptr, param.default_needs_check, static_cast<uint16_t>(param.slot)});
+
+        chunk->write(OpCode::PARAM);
+        chunk->writeByte(static_cast<uint8_t>(i));
+        size_t skip_offset = chunk->code.size();
+        chunk->writeU16(0);
+
+        if (param.default_value)
+        {
+            compileExpression(param.default_value);
+            chunk->write(OpCode::BIND_DEFAULT);
+            chunk->writeByte(static_cast<uint8_t>(i));
+
+            size_t skip = chunk->code.size() - (skip_offset + 2);
+            if (skip > std::numeric_limits<uint16_t>::max())
+            {
+                throw std::runtime_error("Compile error: Default value for parameter '" + std::string(param.name) + "' is too large.");
+            }
+            chunk->patchU16(skip_offset, static_cast<uint16_t>(skip));
+        }
+    }
+
+    for (const auto &stmt : node->body->statements)
+    {
+        compileStatement(stmt);
+    }
+    emitConstant(proto->default_return_value);
+    chunk->write(OpCode::RETURN);
+
+    chunk = enclosing;
+    stringConstants = std::move(saved_strings);
+    integerConstants = std::move(saved_integers);
+    nameIndices = std::move(saved_names);
+}
+
+void Compiler::compileDeclarationStatement(DeclarationStatement *node)
+{
+    if (node->value)
+    {
+        compileExpression(node->value);
+    }
+    else
+    {
+        emitConstant(defaultValueForTypeKeyword(node->declared_type));
+    }
+    if (node->needs_type_check)
+    {
+        emitVariableOp(OpCode::DECLARE_GLOBAL, OpCode::DECLARE_LOCAL, node->target);
+    }
+    else
+    {
+        emitVariableOp(OpCode::DECLARE_GLOBAL_UNCHECKED, OpCode::DECLARE_LOCAL_UNCHECKED, node->target);
+    }
+    chunk->writeByte(static_cast<uint8_t>(tokenTypeToDeclaredType(node->declared_type)));
+}
+
+void Compiler::compileAssignmentStatement(AssignmentStatement *node)
+{
+    compileExpression(node->value);
+    if (node->needs_type_check)
+    {
+        emitVariableOp(OpCode::SET_GLOBAL, OpCode::SET_LOCAL, node->target);
+    }
+    else
+    {
+        emitVariableOp(OpCode::SET_GLOBAL_UNCHECKED, OpCode::SET_LOCAL_UNCHECKED, node->target);
+    }
+}
+
+void Compiler::compileReturnStatement(ReturnStatement *node)
+{
+    compileExpression(node->expression);
+    chunk->write(OpCode::RETURN);
+}
+
+void Compiler::compileBinaryOpExpr(BinaryOpExpr *node)
+{
+    compileExpression(node->left);
+    compileExpression(node->right);
+
+    switch (node->op)
+    {
+    case TokenType::PLUS:
+        chunk->write(OpCode::ADD);
+        break;
+    case TokenType::MINUS:
+        chunk->write(OpCode::SUBTRACT);
+        break;
+    case TokenType::STAR:
+        chunk->write(OpCode::MULTIPLY);
+        break;
+    case TokenType::SLASH:
+        chunk->write(OpCode::DIVIDE);
+        break;
+    case TokenType::GREATER:
+        chunk->write(OpCode::GREATER);
+        break;
+    case TokenType::GREATER_EQUAL:
+        chunk->write(OpCode::GREATER_EQUAL);
+        break;
+    case TokenType::LESS:
+        chunk->write(OpCode::LESS);
+        break;
+    case TokenType::LESS_EQUAL:
+        chunk->write(OpCode::LESS_EQUAL);
+        break;
+    case TokenType::EQUAL_EQUAL:
+        chunk->write(OpCode::EQUAL);
+        break;
+    case TokenType::BANG_EQUAL:
+        chunk->write(OpCode::NOT_EQUAL);
+        break;
+    case TokenType::AND:
+        chunk->write(OpCode::AND);
+        break;
+    case TokenType::OR:
+        chunk->write(OpCode::OR);
+        break;
+    case TokenType::PIPE:
+        chunk->write(OpCode::BIT_OR);
+        break;
+    case TokenType::DOT:
+        chunk->write(OpCode::CONCAT);
+        break;
+    default:
+        chunk->write(OpCode::POP);
+        chunk->write(OpCode::POP);
+        emitRuntimeError("Unsupported binary operator.");
+        break;
+    }
+}
+
+void Compiler::compileUnaryOpExpr(UnaryOpExpr *node)
+{
+    compileExpression(node->right);
+
+    switch (node->op)
+    {
+    case TokenType::MINUS:
+        chunk->write(OpCode::NEGATE);
+        break;
+    case TokenType::BANG:
+    case TokenType::NOT:
+        chunk->write(OpCode::NOT);
+        break;
+    default:
+        chunk->write(OpCode::POP);
+        emitRuntimeError("Unsupported unary operator.");
+        break;
+    }
+}
+
+void Compiler::compileCallExpr(CallExpr *node)
+{
+    auto *callee_var = node_cast<VariableExpr>(node->callee);
+    if (!callee_var)
+    {
+        emitRuntimeError("Runtime error: Callee in function call is not a simple identifier.");
+        return;
+    }
+    if (node->arguments.size() > std::numeric_limits<uint8_t>::max())
+    {
+        throw std::runtime_error("Compile error: Too many arguments in call to '" + std::string(callee_var->name) + "'.");
+    }
+
+    for (const auto &arg : node->arguments)
+    {
+        compileExpression(arg);
+    }
+    chunk->write(node->arguments_need_check ? OpCode::CALL : OpCode::CALL_UNCHECKED);
+    chunk->writeU32(node->function_slot);
+    chunk->writeByte(static_cast<uint8_t>(node->arguments.size()));
+}
@@ -0,0 +1,51 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "bytecode.h"
+#include "../parser/ast.h"
+
+class Compiler
+{
+private:
+    const Interner &symbols;
+    CompiledProgram *program;
+    Chunk *chunk;
+
+    std::unordered_map<std::string, uint32_t> stringConstants;
+    std::unordered_map<long long, uint32_t> integerConstants;
+    std::unordered_map<Symbol, uint32_t> nameIndices;
+
+    uint32_t addConstant(const Value &value);
+    uint32_t addName(Symbol symbol, std::string_view name);
+
+    void emitConstant(const Value &value);
+    void emitNameOp(OpCode op, Symbol symbol, std::string_view name);
+    void emitVariableOp(OpCode global_op, OpCode local_op, VariableExpr *var);
+    void emitRuntimeError(const std::string &message);
+
+    void compileStatement(ASTNode *node);
+    void compileExpression(ASTNode *node);
+
+    void compileFunctionDeclaration(FunctionDeclaration *node);
+    void compileDeclarationStatement(DeclarationStatement *node);
+    void compileAssignmentStatement(AssignmentStatement *node);
+    void compileReturnStatement(ReturnStatement *node);
+    void compileBinaryOpExpr(BinaryOpExpr *node);
+    void compileUnaryOpExpr(UnaryOpExpr *node);
+    void compileCallExpr(CallExpr *node);
+
+    void beginChunk(Chunk *target);
+
+public:
+    Compiler(const Interner &symbols);
+
+    std::unique_ptr<CompiledProgram> compile(ProgramNode *node);
+    void compileFunctionBody(FunctionDeclaration *node, FunctionProto *proto);
+};
+
+#endif
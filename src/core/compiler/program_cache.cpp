@@ -0,0 +1,641 @@
+#include "program_cache.h"
+#include "../common/source_buffer.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_set>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+static constexpr char CACHE_MAGIC[4] = {'M', 'C', 'L', 'C'};
+static constexpr uint32_t CACHE_FORMAT_VERSION = 6;
+
+static uint64_t hashBytes(std::string_view bytes, uint64_t seed = 0x9E3779B97F4A7C15ull)
+{
+    uint64_t hash = seed ^ bytes.size();
+    const char *p = bytes.data();
+    size_t remaining = bytes.size();
+    while (remaining >= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 29;
+        p += 8;
+        remaining -= 8;
+    }
+    if (remaining > 0)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, p, remaining);
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+    }
+    hash ^= hash >> 32;
+    return hash * 0xC4CEB9FE1A85EC53ull;
+}
+
+static uint64_t interpreterIdentity()
+{
+    static const uint64_t identity = []
+    {
+        std::string stamp = std::to_string(CACHE_FORMAT_VERSION) + " " + __DATE__ + " " + __TIME__;
+        std::error_code ec;
+        fs::path exe = fs::read_symlink("/proc/self/exe", ec);
+        if (!ec)
+        {
+            auto size = fs::file_size(exe, ec);
+            if (!ec)
+            {
+                stamp += " " + std::to_string(size);
+            }
+            auto modified = fs::last_write_time(exe, ec);
+            if (!ec)
+            {
+                stamp += " " + std::to_string(modified.time_since_epoch().count());
+            }
+        }
+        return hashBytes(stamp);
+    }();
+    return identity;
+}
+
+class CacheWriter
+{
+public:
+    std::string bytes;
+
+    void u8(uint8_t value) { bytes.push_back(static_cast<char>(value)); }
+    void u32(uint32_t value) { bytes.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+    void u64(uint64_t value) { bytes.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+    void string(std::string_view text)
+    {
+        u32(static_cast<uint32_t>(text.size()));
+        bytes.append(text.data(), text.size());
+    }
+
+    void value(const Value &val)
+    {
+        u8(static_cast<uint8_t>(val.index()));
+        if (auto *s = std::get_if<std::string>(&val))
+        {
+            string(*s);
+        }
+        else if (auto *ll = std::get_if<long long>(&val))
+        {
+            u64(static_cast<uint64_t>(*ll));
+        }
+        else if (auto *d = std::get_if<double>(&val))
+        {
+            uint64_t bits;
+            std::memcpy(&bits, d, sizeof(bits));
+            u64(bits);
+        }
+        else if (auto *b = std::get_if<bool>(&val))
+        {
+            u8(*b ? 1 : 0);
+        }
+    }
+
+    void names(const std::vector<std::string> &list)
+    {
+        u32(static_cast<uint32_t>(list.size()));
+        for (const auto &name : list)
+        {
+            string(name);
+        }
+    }
+
+    void chunk(const Chunk &chunk)
+    {
+        string(std::string_view(reinterpret_cast<const char *>(chunk.code.data()), chunk.code.size()));
+        u32(static_cast<uint32_t>(chunk.constants.size()));
+        for (const auto &constant : chunk.constants)
+        {
+            value(constant);
+        }
+        names(chunk.names);
+        for (Symbol symbol : chunk.name_symbols)
+        {
+            u32(symbol);
+        }
+    }
+};
+
+class CacheReader
+{
+private:
+    const char *cursor;
+    const char *end;
+
+    const char *take(size_t size)
+    {
+        if (static_cast<size_t>(end - cursor) < size)
+        {
+            throw std::runtime_error("Truncated program cache.");
+        }
+        const char *start = cursor;
+        cursor += size;
+        return start;
+    }
+
+public:
+    CacheReader(std::string_view bytes) : cursor(bytes.data()), end(bytes.data() + bytes.size()) {}
+
+    bool atEnd() const { return cursor == end; }
+
+    std::string_view rest()
+    {
+        std::string_view remaining(cursor, static_cast<size_t>(end - cursor));
+        cursor = end;
+        return remaining;
+    }
+
+    uint32_t count(size_t element_size)
+    {
+        uint32_t value = u32();
+        if (value > static_cast<size_t>(end - cursor) / element_size)
+        {
+            throw std::runtime_error("Corrupt count in program cache.");
+        }
+        return value;
+    }
+
+    uint8_t u8() { return static_cast<uint8_t>(*take(1)); }
+
+    uint32_t u32()
+    {
+        uint32_t value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    uint64_t u64()
+    {
+        uint64_t value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    std::string_view string()
+    {
+        uint32_t size = u32();
+        return std::string_view(take(size), size);
+    }
+
+    Value value()
+    {
+        switch (u8())
+        {
+        case 0:
+            return std::string(string());
+        case 1:
+            return static_cast<long long>(u64());
+        case 2:
+        {
+            uint64_t bits = u64();
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+        case 3:
+            return u8() != 0;
+        case 4:
+            return std::monostate{};
+        default:
+            throw std::runtime_error("Corrupt value in program cache.");
+        }
+    }
+
+    void names(std::vector<std::string> &list)
+    {
+        uint32_t size = count(sizeof(uint32_t));
+        list.reserve(size);
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            list.emplace_back(string());
+        }
+    }
+
+    void chunk(Chunk &chunk)
+    {
+        std::string_view code = string();
+        chunk.code.assign(code.begin(), code.end());
+        uint32_t constants = count(1);
+        chunk.constants.reserve(constants);
+        for (uint32_t i = 0; i < constants; ++i)
+        {
+            chunk.constants.push_back(value());
+        }
+        names(chunk.names);
+        chunk.name_symbols.reserve(chunk.names.size());
+        for (size_t i = 0; i < chunk.names.size(); ++i)
+        {
+            chunk.name_symbols.push_back(u32());
+        }
+    }
+};
+
+static size_t instructionLength(OpCode op)
+{
+    switch (op)
+    {
+    case OpCode::POP:
+    case OpCode::ADD:
+    case OpCode::SUBTRACT:
+    case OpCode::MULTIPLY:
+    case OpCode::DIVIDE:
+    case OpCode::GREATER:
+    case OpCode::GREATER_EQUAL:
+    case OpCode::LESS:
+    case OpCode::LESS_EQUAL:
+    case OpCode::EQUAL:
+    case OpCode::NOT_EQUAL:
+    case OpCode::AND:
+    case OpCode::OR:
+    case OpCode::BIT_OR:
+    case OpCode::CONCAT:
+    case OpCode::NEGATE:
+    case OpCode::NOT:
+    case OpCode::ECHO:
+    case OpCode::RETURN:
+    case OpCode::HALT:
+        return 1;
+    case OpCode::BIND_DEFAULT:
+        return 2;
+    case OpCode::GET_LOCAL:
+    case OpCode::SET_LOCAL:
+    case OpCode::SET_LOCAL_UNCHECKED:
+        return 3;
+    case OpCode::DECLARE_LOCAL:
+    case OpCode::DECLARE_LOCAL_UNCHECKED:
+    case OpCode::PARAM:
+        return 4;
+    case OpCode::CONSTANT:
+    case OpCode::GET_GLOBAL:
+    case OpCode::SET_GLOBAL:
+    case OpCode::SET_GLOBAL_UNCHECKED:
+    case OpCode::GET_DYNAMIC:
+    case OpCode::DEFINE_FUNCTION:
+    case OpCode::RUNTIME_ERROR:
+        return 5;
+    case OpCode::DECLARE_GLOBAL:
+    case OpCode::DECLARE_GLOBAL_UNCHECKED:
+    case OpCode::CALL:
+    case OpCode::CALL_UNCHECKED:
+        return 6;
+    case OpCode::SET_DYNAMIC:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+static bool validDeclaredType(uint8_t type)
+{
+    return type <= static_cast<uint8_t>(DeclaredType::BOOLEAN);
+}
+
+static bool uniqueNames(const std::vector<std::string> &names)
+{
+    std::unordered_set<std::string_view> seen;
+    for (const auto &name : names)
+    {
+        if (!seen.insert(name).second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool validChunk(const Chunk &chunk, const CompiledProgram &program, const FunctionProto *function, uint64_t symbol_limit)
+{
+    for (Symbol symbol : chunk.name_symbols)
+    {
+        if (symbol >= symbol_limit)
+        {
+            return false;
+        }
+    }
+
+    const std::vector<uint8_t> &code = chunk.code;
+    size_t locals = function ? function->local_names.size() : 0;
+    size_t parameters = function ? function->parameters.size() : 0;
+    std::vector<size_t> depths(code.size() + 1, SIZE_MAX);
+    std::vector<std::pair<size_t, size_t>> jumps;
+    OpCode last = OpCode::HALT;
+    size_t depth = 0;
+
+    size_t offset = 0;
+    while (offset < code.size())
+    {
+        depths[offset] = depth;
+        last = static_cast<OpCode>(code[offset]);
+        size_t length = instructionLength(last);
+        if (length == 0 || code.size() - offset < length)
+        {
+            return false;
+        }
+
+        const uint8_t *operands = code.data() + offset + 1;
+        bool valid = true;
+        size_t pops = 0;
+        size_t pushes = 0;
+        switch (last)
+        {
+        case OpCode::CONSTANT:
+            valid = readU32(operands) < chunk.constants.size();
+            pushes = 1;
+            break;
+        case OpCode::RUNTIME_ERROR:
+            valid = readU32(operands) < chunk.constants.size() && std::holds_alternative<std::string>(chunk.constants[readU32(operands)]);
+            break;
+        case OpCode::POP:
+        case OpCode::ECHO:
+        case OpCode::RETURN:
+            pops = 1;
+            break;
+        case OpCode::GET_GLOBAL:
+            valid = readU32(operands) < program.global_names.size();
+            pushes = 1;
+            break;
+        case OpCode::SET_GLOBAL:
+        case OpCode::SET_GLOBAL_UNCHECKED:
+            valid = readU32(operands) < program.global_names.size();
+            pops = 1;
+            break;
+        case OpCode::DECLARE_GLOBAL:
+        case OpCode::DECLARE_GLOBAL_UNCHECKED:
+            valid = readU32(operands) < program.global_names.size() && validDeclaredType(operands[4]);
+            pops = 1;
+            break;
+        case OpCode::GET_LOCAL:
+            valid = readU16(operands) < locals;
+            pushes = 1;
+            break;
+        case OpCode::SET_LOCAL:
+        case OpCode::SET_LOCAL_UNCHECKED:
+            valid = readU16(operands) < locals;
+            pops = 1;
+            break;
+        case OpCode::DECLARE_LOCAL:
+        case OpCode::DECLARE_LOCAL_UNCHECKED:
+            valid = readU16(operands) < locals && validDeclaredType(operands[2]);
+            pops = 1;
+            break;
+        case OpCode::GET_DYNAMIC:
+            valid = function && readU32(operands) < chunk.names.size();
+            pushes = 1;
+            break;
+        case OpCode::SET_DYNAMIC:
+            valid = readU32(operands) < chunk.names.size() && readU16(operands + 4) < locals;
+            pops = 1;
+            break;
+        case OpCode::NEGATE:
+        case OpCode::NOT:
+            pops = 1;
+            pushes = 1;
+            break;
+        case OpCode::CALL:
+        case OpCode::CALL_UNCHECKED:
+            valid = readU32(operands) < program.function_names.size();
+            pops = operands[4];
+            pushes = 1;
+            break;
+        case OpCode::DEFINE_FUNCTION:
+            valid = readU32(operands) < program.functions.size();
+            break;
+        case OpCode::PARAM:
+            valid = operands[0] < parameters;
+            jumps.emplace_back(offset + length + readU16(operands + 1), depth);
+            break;
+        case OpCode::BIND_DEFAULT:
+            valid = operands[0] < parameters;
+            pops = 1;
+            break;
+        case OpCode::HALT:
+            break;
+        default:
+            pops = 2;
+            pushes = 1;
+            break;
+        }
+        if (!valid || depth < pops)
+        {
+            return false;
+        }
+        depth = depth - pops + pushes;
+        offset += length;
+    }
+
+    for (const auto &[target, expected] : jumps)
+    {
+        if (target >= code.size() || depths[target] != expected)
+        {
+            return false;
+        }
+    }
+    return !code.empty() && last == (function ? OpCode::RETURN : OpCode::HALT);
+}
+
+static bool validProgram(const CompiledProgram &program, uint64_t symbol_limit)
+{
+    if (program.type_checks_elided > program.type_checks || !uniqueNames(program.global_names) || !uniqueNames(program.function_names) ||
+        !validChunk(program.main, program, nullptr, symbol_limit))
+    {
+        return false;
+    }
+
+    for (const auto &proto : program.functions)
+    {
+        if (proto->slot >= program.function_names.size() || proto->local_names.size() > UINT16_MAX ||
+            proto->parameters.size() > UINT8_MAX || !validDeclaredType(static_cast<uint8_t>(proto->return_type)))
+        {
+            return false;
+        }
+        for (const auto &param : proto->parameters)
+        {
+            if (param.slot >= proto->local_names.size() || !validDeclaredType(static_cast<uint8_t>(param.declared_type)))
+            {
+                return false;
+            }
+        }
+        for (Symbol symbol : proto->local_symbols)
+        {
+            if (symbol >= symbol_limit)
+            {
+                return false;
+            }
+        }
+        if (!validChunk(proto->chunk, program, proto.get(), symbol_limit))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+ProgramCache::ProgramCache(const std::string &source_path, std::string_view source, std::string_view environment, const std::string &cache_dir)
+    : environmentHash(hashBytes(environment)), sourceHash(hashBytes(source)), sourceSize(source.size())
+{
+    if (cache_dir.empty())
+    {
+        cachePath = fs::path(source_path).replace_extension(".mclc").string();
+        return;
+    }
+
+    std::error_code ec;
+    std::string absolute = fs::absolute(source_path, ec).lexically_normal().string();
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hashBytes(ec ? source_path : absolute)));
+    cachePath = (fs::path(cache_dir) / (std::string(name) + ".mclc")).string();
+}
+
+std::unique_ptr<CompiledProgram> ProgramCache::load() const
+{
+    std::unique_ptr<SourceBuffer> file = SourceBuffer::open(cachePath);
+    if (!file)
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        CacheReader header(file->text());
+        uint32_t magic = header.u32();
+        if (std::memcmp(&magic, CACHE_MAGIC, sizeof(magic)) != 0 || header.u32() != CACHE_FORMAT_VERSION ||
+            header.u64() != interpreterIdentity() || header.u64() != environmentHash || header.u64() != sourceHash ||
+            header.u64() != sourceSize)
+        {
+            return nullptr;
+        }
+
+        uint64_t payload_hash = header.u64();
+        std::string_view payload = header.rest();
+        if (hashBytes(payload) != payload_hash)
+        {
+            return nullptr;
+        }
+
+        CacheReader reader(payload);
+        auto program = std::make_unique<CompiledProgram>();
+        reader.names(program->global_names);
+        reader.names(program->function_names);
+        reader.chunk(program->main);
+
+        uint32_t function_count = reader.count(1);
+        for (uint32_t i = 0; i < function_count; ++i)
+        {
+            auto proto = std::make_unique<FunctionProto>();
+            proto->name = std::string(reader.string());
+            proto->slot = reader.u32();
+            uint32_t parameter_count = reader.count(1);
+            for (uint32_t p = 0; p < parameter_count; ++p)
+            {
+                ParameterProto param;
+                param.name = std::string(reader.string());
+                param.declared_type = static_cast<DeclaredType>(reader.u8());
+                param.has_default = reader.u8() != 0;
+                param.check_default = reader.u8() != 0;
+                param.slot = static_cast<uint16_t>(reader.u32());
+                proto->parameters.push_back(std::move(param));
+            }
+            proto->return_type = static_cast<DeclaredType>(reader.u8());
+            proto->check_return = reader.u8() != 0;
+            proto->default_return_value = reader.value();
+            reader.names(proto->local_names);
+            for (size_t l = 0; l < proto->local_names.size(); ++l)
+            {
+                proto->local_symbols.push_back(reader.u32());
+            }
+            reader.chunk(proto->chunk);
+            program->functions.push_back(std::move(proto));
+        }
+        program->type_checks = reader.u64();
+        program->type_checks_elided = reader.u64();
+
+        return reader.atEnd() && validProgram(*program, sourceSize) ? std::move(program) : nullptr;
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+bool ProgramCache::store(const CompiledProgram &program) const
+{
+    CacheWriter writer;
+    writer.names(program.global_names);
+    writer.names(program.function_names);
+    writer.chunk(program.main);
+
+    writer.u32(static_cast<uint32_t>(program.functions.size()));
+    for (const auto &proto : program.functions)
+    {
+        if (proto->deferred)
+        {
+            return false;
+        }
+        writer.string(proto->name);
+        writer.u32(proto->slot);
+        writer.u32(static_cast<uint32_t>(proto->parameters.size()));
+        for (const auto &param : proto->parameters)
+        {
+            writer.string(param.name);
+            writer.u8(static_cast<uint8_t>(param.declared_type));
+            writer.u8(param.has_default ? 1 : 0);
+            writer.u8(param.check_default ? 1 : 0);
+            writer.u32(param.slot);
+        }
+        writer.u8(static_cast<uint8_t>(proto->return_type));
+        writer.u8(proto->check_return ? 1 : 0);
+        writer.value(proto->default_return_value);
+        writer.names(proto->local_names);
+        for (Symbol symbol : proto->local_symbols)
+        {
+            writer.u32(symbol);
+        }
+        writer.chunk(proto->chunk);
+    }
+    writer.u64(program.type_checks);
+    writer.u64(program.type_checks_elided);
+
+    CacheWriter header;
+    header.bytes.append(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.u32(CACHE_FORMAT_VERSION);
+    header.u64(interpreterIdentity());
+    header.u64(environmentHash);
+    header.u64(sourceHash);
+    header.u64(sourceSize);
+    header.u64(hashBytes(writer.bytes));
+
+    std::error_code ec;
+    fs::path target(cachePath);
+    if (target.has_parent_path())
+    {
+        fs::create_directories(target.parent_path(), ec);
+    }
+
+    std::string temporary = cachePath + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.write(header.bytes.data(), static_cast<std::streamsize>(header.bytes.size())) ||
+            !out.write(writer.bytes.data(), static_cast<std::streamsize>(writer.bytes.size())))
+        {
+            fs::remove(temporary, ec);
+            return false;
+        }
+    }
+    fs::rename(temporary, target, ec);
+    if (ec)
+    {
+        fs::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "bytecode.h"
+
+class ProgramCache
+{
+private:
+    std::string cachePath;
+    uint64_t environmentHash;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+
+public:
+    ProgramCache(const std::string &source_path, std::string_view source, std::string_view environment, const std::string &cache_dir);
+
+    const std::string &path() const { return cachePath; }
+
+    std::unique_ptr<CompiledProgram> load() const;
+    bool store(const CompiledProgram &program) const;
+};
+
+#endif
@@ -1,26 +1,105 @@
 #include "lexer.h"
+#include "scanner.h"
 #include <iostream>
 #include <cctype>
 #include <string>
 #include <stdexcept>
-#include <map>
-
-static const std::map<std::string, TokenType> keywords = {
-    {"echo", TokenType::ECHO},
-    {"true", TokenType::TRUE},
-    {"false", TokenType::FALSE},
-    {"and", TokenType::AND},
-    {"or", TokenType::OR},
-    {"not", TokenType::NOT},
-    {"public", TokenType::PUBLIC},
-    {"function", TokenType::FUNCTION},
-    {"return", TokenType::RETURN},
-    {"string", TokenType::STRING_KEYWORD},
-    {"integer", TokenType::INTEGER_KEYWORD},
-    {"number", TokenType::NUMBER_KEYWORD},
-    {"boolean", TokenType::BOOLEAN_KEYWORD}};
-
-Lexer::Lexer(std::string source) : source(std::move(source)), current(0), line(1) {}
+#include <charconv>
+#include <system_error>
+
+struct IdentifierTable
+{
+    bool chars[256] = {};
+
+    constexpr IdentifierTable()
+    {
+        for (int c = 'a'; c <= 'z'; ++c)
+            chars[c] = true;
+        for (int c = 'A'; c <= 'Z'; ++c)
+            chars[c] = true;
+        for (int c = '0'; c <= '9'; ++c)
+            chars[c] = true;
+        chars['_'] = true;
+        chars['-'] = true;
+    }
+};
+
+static constexpr IdentifierTable identifierTable;
+
+static constexpr TokenType keywordType(std::string_view text)
+{
+    switch (text.size())
+    {
+    case 2:
+        if (text == "or")
+            return TokenType::OR;
+        break;
+    case 3:
+        if (text == "and")
+            return TokenType::AND;
+        if (text == "not")
+            return TokenType::NOT;
+        break;
+    case 4:
+        if (text == "echo")
+            return TokenType::ECHO;
+        if (text == "true")
+            return TokenType::TRUE;
+        break;
+    case 5:
+        if (text == "false")
+            return TokenType::FALSE;
+        break;
+    case 6:
+        switch (text[0])
+        {
+        case 'p':
+            if (text == "public")
+                return TokenType::PUBLIC;
+            break;
+        case 'r':
+            if (text == "return")
+                return TokenType::RETURN;
+            break;
+        case 's':
+            if (text == "string")
+                return TokenType::STRING_KEYWORD;
+            break;
+        case 'n':
+            if (text == "number")
+                return TokenType::NUMBER_KEYWORD;
+            break;
+        }
+        break;
+    case 7:
+        if (text == "integer")
+            return TokenType::INTEGER_KEYWORD;
+        if (text == "boolean")
+            return TokenType::BOOLEAN_KEYWORD;
+        break;
+    case 8:
+        if (text == "function")
+            return TokenType::FUNCTION;
+        break;
+    }
+    return TokenType::IDENTIFIER;
+}
+
+static_assert(keywordType("function") == TokenType::FUNCTION && keywordType("functions") == TokenType::IDENTIFIER);
+
+Lexer::Lexer(std::string_view source) : source(source), current(0), line(1) {}
+
+void Lexer::seek(size_t offset, int startLine)
+{
+    current = offset;
+    line = startLine;
+}
+
+size_t Lexer::skipTrivia()
+{
+    skipWhitespace();
+    return current;
+}
 
 char Lexer::peek()
 {
@@ -56,194 +135,258 @@ char Lexer::advance()
 
 void Lexer::skipWhitespace()
 {
-    while (true)
+    const char *begin = source.data();
+    const char *end = begin + source.size();
+    const char *start = begin + current;
+    const char *p = start;
+
+    while (p < end)
     {
-        char c = peek();
-        if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+        char c = *p;
+        if (is_blank(c))
         {
-            advance();
+            p = scan_past_blanks(p + 1, end);
             continue;
         }
 
-        if (c == '/')
+        if (c == '/' && p + 1 < end && p[1] == '/')
         {
-            if (peekNext() == '/')
-            {
-                advance();
-                advance();
-                while (peek() != '\n' && peek() != '\0')
-                {
-                    advance();
-                }
-                continue;
-            }
-            else if (peekNext() == '*')
+            p = scan_until_either(p + 2, end, '\n', '\0');
+            continue;
+        }
+
+        if (c == '/' && p + 1 < end && p[1] == '*')
+        {
+            p += 2;
+            while (true)
             {
-                advance();
-                advance();
-                while (!(peek() == '*' && peekNext() == '/') && peek() != '\0')
+                p = scan_until_either(p, end, '*', '\0');
+                if (p == end || *p == '\0')
                 {
-                    advance();
+                    break;
                 }
-                if (peek() != '\0')
+                if (p + 1 < end && p[1] == '/')
                 {
-                    advance();
-                    advance();
+                    p += 2;
+                    break;
                 }
-                continue;
+                ++p;
             }
+            continue;
         }
-        else if (c == '#')
+
+        if (c == '#')
         {
-            advance();
-            while (peek() != '\n' && peek() != '\0')
-            {
-                advance();
-            }
+            p = scan_until_either(p + 1, end, '\n', '\0');
             continue;
         }
         break;
     }
+
+    line += static_cast<int>(count_newlines(start, p));
+    current = static_cast<size_t>(p - begin);
 }
 
 Token Lexer::identifierOrKeyword()
 {
-    std::string lexeme;
+    size_t start = current;
     int startLine = line;
 
-    if (peek() == '$')
+    bool variable = source[current] == '$';
+    size_t end = variable ? current + 1 : current;
+    while (end < source.size() && identifierTable.chars[static_cast<unsigned char>(source[end])])
     {
-        lexeme += advance();
+        ++end;
     }
+    current = end;
 
-    while (std::isalnum(peek()) || peek() == '_' || peek() == '-')
-    {
-        lexeme += advance();
-    }
-
-    if (lexeme.empty() || lexeme[0] != '$')
-    {
-        auto it = keywords.find(lexeme);
-        if (it != keywords.end())
-        {
-            if (it->second == TokenType::TRUE)
-                return Token(TokenType::TRUE, lexeme, true, startLine);
-            if (it->second == TokenType::FALSE)
-                return Token(TokenType::FALSE, lexeme, false, startLine);
-            return Token(it->second, lexeme, startLine);
-        }
-    }
+    std::string_view lexeme = source.substr(start, current - start);
 
-    return Token(TokenType::IDENTIFIER, lexeme, startLine);
+    TokenType type = variable ? TokenType::IDENTIFIER : keywordType(lexeme);
+    if (type == TokenType::TRUE)
+        return Token(TokenType::TRUE, lexeme, true, startLine);
+    if (type == TokenType::FALSE)
+        return Token(TokenType::FALSE, lexeme, false, startLine);
+    return Token(type, lexeme, startLine);
 }
 
 Token Lexer::string()
 {
+    size_t start = current;
     int startLine = line;
     advance();
-    std::string value;
 
     while (peek() != '"' && peek() != '\0')
     {
         if (peek() == '\\')
         {
             advance();
-            char escaped_char = peek();
-            if (escaped_char == '\0')
+            if (peek() == '\0')
             {
                 throw std::runtime_error("Unterminated escape sequence in string literal at line " + std::to_string(startLine) + ".");
             }
+        }
+        advance();
+    }
+
+    if (peek() == '\0')
+    {
+        throw std::runtime_error("Unterminated string literal at line " + std::to_string(startLine) + ".");
+    }
+
+    advance();
+
+    return makeToken(TokenType::STRING_LITERAL, start, startLine);
+}
 
-            switch (escaped_char)
+std::string_view Lexer::decodeString(std::string_view lexeme, char *out)
+{
+    std::string_view body = lexeme.substr(1, lexeme.size() - 2);
+    size_t length = 0;
+
+    for (size_t i = 0; i < body.size(); ++i)
+    {
+        char c = body[i];
+        if (c == '\\')
+        {
+            switch (body[++i])
             {
-            case '"':
-                value += '"';
-                break;
-            case '\\':
-                value += '\\';
-                break;
             case 'n':
-                value += '\n';
+                c = '\n';
                 break;
             case 't':
-                value += '\t';
+                c = '\t';
                 break;
             default:
-                value += escaped_char;
+                c = body[i];
                 break;
             }
-            advance();
-        }
-        else
-        {
-            value += advance();
         }
+        out[length++] = c;
     }
 
-    if (peek() == '\0')
+    return std::string_view(out, length);
+}
+
+static bool isDigitInBase(char c, int base)
+{
+    if (base == 2)
     {
-        throw std::runtime_error("Unterminated string literal at line " + std::to_string(startLine) + ".");
+        return c == '0' || c == '1';
     }
+    if (base == 16)
+    {
+        return std::isxdigit(static_cast<unsigned char>(c));
+    }
+    return c >= '0' && c <= '9';
+}
 
-    advance();
-
-    return Token(TokenType::STRING_LITERAL, "\"" + value + "\"", value, startLine);
+static const char *skipDigits(const char *p, const char *end, int base)
+{
+    while (p < end && isDigitInBase(*p, base))
+    {
+        ++p;
+    }
+    return p;
 }
 
 Token Lexer::number()
 {
-    std::string lexeme;
     int startLine = line;
-    bool has_decimal = false;
+    const char *begin = source.data() + current;
+    const char *end = source.data() + source.size();
 
-    while (std::isdigit(peek()))
+    int base = 10;
+    if (begin[0] == '0' && end - begin > 2)
     {
-        lexeme += advance();
+        if ((begin[1] == 'x' || begin[1] == 'X') && isDigitInBase(begin[2], 16))
+        {
+            base = 16;
+        }
+        else if ((begin[1] == 'b' || begin[1] == 'B') && isDigitInBase(begin[2], 2))
+        {
+            base = 2;
+        }
     }
 
-    if (peek() == '.' && std::isdigit(peekNext()))
+    const char *digits = base == 10 ? begin : begin + 2;
+    const char *p = skipDigits(digits, end, base);
+
+    if (base == 10)
     {
-        has_decimal = true;
-        lexeme += advance();
+        if (p + 1 < end && *p == '.' && isDigitInBase(p[1], 10))
+        {
+            p = skipDigits(p + 1, end, 10);
+        }
 
-        while (std::isdigit(peek()))
+        if (p < end && (*p == 'e' || *p == 'E'))
         {
-            lexeme += advance();
+            const char *exponent = p + 1;
+            if (exponent < end && (*exponent == '+' || *exponent == '-'))
+            {
+                ++exponent;
+            }
+            if (exponent < end && isDigitInBase(*exponent, 10))
+            {
+                p = skipDigits(exponent, end, 10);
+            }
         }
     }
 
-    if (has_decimal)
+    current += static_cast<size_t>(p - begin);
+    std::string_view lexeme(begin, static_cast<size_t>(p - begin));
+    return Token(TokenType::NUMBER_LITERAL, lexeme, numberLiteral(lexeme, startLine), startLine);
+}
+
+TokenLiteral Lexer::numberLiteral(std::string_view lexeme, int line)
+{
+    const char *begin = lexeme.data();
+    const char *end = begin + lexeme.size();
+
+    int base = 10;
+    if (lexeme.size() > 2 && lexeme[0] == '0')
     {
-        try
-        {
-            double value = std::stod(lexeme);
-            return Token(TokenType::NUMBER_LITERAL, lexeme, value, startLine);
-        }
-        catch (const std::out_of_range &)
+        if (lexeme[1] == 'x' || lexeme[1] == 'X')
         {
-            throw std::runtime_error("Number literal out of range: " + lexeme + " at line " + std::to_string(startLine) + ".");
+            base = 16;
         }
-        catch (const std::invalid_argument &)
+        else if (lexeme[1] == 'b' || lexeme[1] == 'B')
         {
-            throw std::runtime_error("Invalid number literal: " + lexeme + " at line " + std::to_string(startLine) + ".");
+            base = 2;
         }
     }
-    else
+
+    if (base == 10 && lexeme.find_first_of(".eE") != std::string_view::npos)
     {
-        try
+        double value = 0.0;
+        std::from_chars_result result = std::from_chars(begin, end, value);
+        if (result.ec == std::errc::result_out_of_range)
         {
-            long long value = std::stoll(lexeme);
-            return Token(TokenType::NUMBER_LITERAL, lexeme, value, startLine);
+            throw std::runtime_error("Number literal out of range: " + std::string(lexeme) + " at line " + std::to_string(line) + ".");
         }
-        catch (const std::out_of_range &)
+        if (result.ec != std::errc() || result.ptr != end)
         {
-            throw std::runtime_error("Integer literal out of range: " + lexeme + " at line " + std::to_string(startLine) + ".");
-        }
-        catch (const std::invalid_argument &)
-        {
-            throw std::runtime_error("Invalid integer literal: " + lexeme + " at line " + std::to_string(startLine) + ".");
+            throw std::runtime_error("Invalid number literal: " + std::string(lexeme) + " at line " + std::to_string(line) + ".");
         }
+        return value;
+    }
+
+    long long value = 0;
+    std::from_chars_result result = std::from_chars(base == 10 ? begin : begin + 2, end, value, base);
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        throw std::runtime_error("Integer literal out of range: " + std::string(lexeme) + " at line " + std::to_string(line) + ".");
+    }
+    if (result.ec != std::errc() || result.ptr != end)
+    {
+        throw std::runtime_error("Invalid integer literal: " + std::string(lexeme) + " at line " + std::to_string(line) + ".");
     }
+    return value;
+}
+
+Token Lexer::makeToken(TokenType type, size_t start, int startLine) const
+{
+    return Token(type, source.substr(start, current - start), startLine);
 }
 
 Token Lexer::getNextToken()
@@ -252,53 +395,54 @@ Token Lexer::getNextToken()
 
     char c = peek();
     int startLine = line;
+    size_t start = current;
 
     if (c == '\0')
     {
-        return Token(TokenType::EOF_TOKEN, "", startLine);
+        return makeToken(TokenType::EOF_TOKEN, start, startLine);
     }
 
     switch (c)
     {
     case ';':
         advance();
-        return Token(TokenType::SEMICOLON, ";", startLine);
+        return makeToken(TokenType::SEMICOLON, start, startLine);
     case '.':
         advance();
-        return Token(TokenType::DOT, ".", startLine);
+        return makeToken(TokenType::DOT, start, startLine);
     case '(':
         advance();
-        return Token(TokenType::LEFT_PAREN, "(", startLine);
+        return makeToken(TokenType::LEFT_PAREN, start, startLine);
     case ')':
         advance();
-        return Token(TokenType::RIGHT_PAREN, ")", startLine);
+        return makeToken(TokenType::RIGHT_PAREN, start, startLine);
     case '{':
         advance();
-        return Token(TokenType::LEFT_BRACE, "{", startLine);
+        return makeToken(TokenType::LEFT_BRACE, start, startLine);
     case '}':
         advance();
-        return Token(TokenType::RIGHT_BRACE, "}", startLine);
+        return makeToken(TokenType::RIGHT_BRACE, start, startLine);
     case '+':
         advance();
-        return Token(TokenType::PLUS, "+", startLine);
+        return makeToken(TokenType::PLUS, start, startLine);
     case '-':
         advance();
-        return Token(TokenType::MINUS, "-", startLine);
+        return makeToken(TokenType::MINUS, start, startLine);
     case '*':
         advance();
-        return Token(TokenType::STAR, "*", startLine);
+        return makeToken(TokenType::STAR, start, startLine);
     case '/':
         advance();
-        return Token(TokenType::SLASH, "/", startLine);
+        return makeToken(TokenType::SLASH, start, startLine);
     case '!':
     {
         advance();
         if (peek() == '=')
         {
             advance();
-            return Token(TokenType::BANG_EQUAL, "!=", startLine);
+            return makeToken(TokenType::BANG_EQUAL, start, startLine);
         }
-        return Token(TokenType::BANG, "!", startLine);
+        return makeToken(TokenType::BANG, start, startLine);
     }
     case '=':
     {
@@ -306,9 +450,9 @@ Token Lexer::getNextToken()
         if (peek() == '=')
         {
             advance();
-            return Token(TokenType::EQUAL_EQUAL, "==", startLine);
+            return makeToken(TokenType::EQUAL_EQUAL, start, startLine);
         }
-        return Token(TokenType::EQUAL, "=", startLine);
+        return makeToken(TokenType::EQUAL, start, startLine);
     }
     case '<':
     {
@@ -316,9 +460,9 @@ Token Lexer::getNextToken()
         if (peek() == '=')
         {
             advance();
-            return Token(TokenType::LESS_EQUAL, "<=", startLine);
+            return makeToken(TokenType::LESS_EQUAL, start, startLine);
         }
-        return Token(TokenType::LESS, "<", startLine);
+        return makeToken(TokenType::LESS, start, startLine);
     }
     case '>':
     {
@@ -326,21 +470,21 @@ Token Lexer::getNextToken()
         if (peek() == '=')
         {
             advance();
-            return Token(TokenType::GREATER_EQUAL, ">=", startLine);
+            return makeToken(TokenType::GREATER_EQUAL, start, startLine);
         }
-        return Token(TokenType::GREATER, ">", startLine);
+        return makeToken(TokenType::GREATER, start, startLine);
     }
     case '"':
         return string();
     case ',':
         advance();
-        return Token(TokenType::COMMA, ",", startLine);
+        return makeToken(TokenType::COMMA, start, startLine);
     case ':':
         advance();
-        return Token(TokenType::COLON, ":", startLine);
+        return makeToken(TokenType::COLON, start, startLine);
     case '|':
         advance();
-        return Token(TokenType::PIPE, "|", startLine);
+        return makeToken(TokenType::PIPE, start, startLine);
     case '$':
         return identifierOrKeyword();
     default:
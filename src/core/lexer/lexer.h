@@ -2,14 +2,15 @@
 #define LEXER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "../common/token.h"
 
 class Lexer
 {
 private:
-    std::string source;
-    int current;
+    std::string_view source;
+    size_t current;
     int line;
 
     char peek();
@@ -17,12 +18,18 @@ private:
     char peekNext();
     void skipWhitespace();
 
+    Token makeToken(TokenType type, size_t start, int startLine) const;
     Token identifierOrKeyword();
     Token string();
     Token number();
 
 public:
-    Lexer(std::string source);
+    Lexer(std::string_view source);
+    void seek(size_t offset, int startLine);
+    size_t skipTrivia();
+    int currentLine() const { return line; }
+    static TokenLiteral numberLiteral(std::string_view lexeme, int line);
+    static std::string_view decodeString(std::string_view lexeme, char *out);
     Token getNextToken();
 };
 
@@ -0,0 +1,140 @@
+#include "parallel_lexer.h"
+#include "scanner.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+ParallelLexer::ParallelLexer(std::string_view source, unsigned threads)
+    : source(source), threads(threads == 0 ? 1 : threads)
+{
+}
+
+void ParallelLexer::split()
+{
+    size_t target = source.size() / (threads * 4) + 1;
+    if (target < MIN_CHUNK_BYTES)
+    {
+        target = MIN_CHUNK_BYTES;
+    }
+
+    size_t start = 0;
+    while (start < source.size())
+    {
+        size_t end = start + target;
+        if (end >= source.size())
+        {
+            end = source.size();
+        }
+        else
+        {
+            const void *newline = std::memchr(source.data() + end, '\n', source.size() - end);
+            end = newline ? static_cast<size_t>(static_cast<const char *>(newline) - source.data()) + 1 : source.size();
+        }
+        chunks.emplace_back(source, start, end);
+        start = end;
+    }
+}
+
+void ParallelLexer::lexChunk(Chunk &chunk, size_t start, int line) const
+{
+    Lexer lexer(source);
+    lexer.seek(start, line);
+    chunk.tokens.reserve(chunk.end - start);
+
+    try
+    {
+        while (true)
+        {
+            chunk.stop = lexer.skipTrivia();
+            chunk.stopLine = lexer.currentLine();
+            if (chunk.stop >= chunk.end)
+            {
+                return;
+            }
+
+            Token token = lexer.getNextToken();
+            chunk.tokens.push(token);
+            if (token.type == TokenType::EOF_TOKEN)
+            {
+                chunk.finished = true;
+                return;
+            }
+        }
+    }
+    catch (...)
+    {
+        chunk.tokens.fail(std::current_exception());
+        chunk.finished = true;
+    }
+}
+
+void ParallelLexer::fill(TokenBuffer &tokens)
+{
+    split();
+
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [this, &nextChunk]()
+    {
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+        {
+            Chunk &chunk = chunks[i];
+            chunk.newlines = count_newlines(source.data() + chunk.start, source.data() + chunk.end);
+            lexChunk(chunk, chunk.start, 1);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    size_t workerCount = threads < chunks.size() ? threads : chunks.size();
+    for (size_t i = 1; i < workerCount; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : workers)
+    {
+        thread.join();
+    }
+
+    tokens.reserve(source.size());
+    size_t expected = 0;
+    int expectedLine = 1;
+    int baseLine = 1;
+
+    for (Chunk &chunk : chunks)
+    {
+        int lineDelta = baseLine - 1;
+        baseLine += static_cast<int>(chunk.newlines);
+        if (expected >= chunk.end)
+        {
+            continue;
+        }
+
+        size_t first = chunk.tokens.lowerBound(expected);
+        bool synced = first < chunk.tokens.size() ? chunk.tokens.offset(first) == expected : chunk.stop == expected;
+        if (!synced || (chunk.tokens.failed() && lineDelta != 0))
+        {
+            chunk.tokens = TokenBuffer(source);
+            chunk.finished = false;
+            lexChunk(chunk, expected, expectedLine);
+            first = 0;
+            lineDelta = 0;
+        }
+
+        tokens.append(chunk.tokens, first, lineDelta);
+        if (chunk.tokens.failed())
+        {
+            tokens.fail(chunk.tokens.failure());
+            return;
+        }
+        if (chunk.finished)
+        {
+            return;
+        }
+
+        expected = chunk.stop;
+        expectedLine = chunk.stopLine + lineDelta;
+        chunk.tokens = TokenBuffer(source);
+    }
+
+    tokens.push(Token(TokenType::EOF_TOKEN, source.substr(source.size()), expectedLine));
+}
@@ -0,0 +1,41 @@
+#ifndef PARALLEL_LEXER_H
+#define PARALLEL_LEXER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+#include "token_buffer.h"
+
+class ParallelLexer
+{
+private:
+    static constexpr size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+    struct Chunk
+    {
+        size_t start;
+        size_t end;
+        TokenBuffer tokens;
+        size_t stop = 0;
+        int stopLine = 1;
+        bool finished = false;
+        size_t newlines = 0;
+
+        Chunk(std::string_view source, size_t start, size_t end) : start(start), end(end), tokens(source) {}
+    };
+
+    std::string_view source;
+    unsigned threads;
+    std::vector<Chunk> chunks;
+
+    void split();
+    void lexChunk(Chunk &chunk, size_t start, int line) const;
+
+public:
+    ParallelLexer(std::string_view source, unsigned threads);
+
+    void fill(TokenBuffer &tokens);
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "token_buffer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+TokenBuffer::TokenBuffer(std::string_view source) : source(source) {}
+
+void TokenBuffer::reserve(size_t bytes)
+{
+    size_t estimate = bytes / 2 + 1;
+    types.reserve(estimate);
+    offsets.reserve(estimate);
+    lengths.reserve(estimate);
+    lines.reserve(estimate);
+}
+
+void TokenBuffer::push(const Token &token)
+{
+    types.push_back(static_cast<uint8_t>(token.type));
+    offsets.push_back(static_cast<uint32_t>(token.lexeme.data() - source.data()));
+    lengths.push_back(static_cast<uint32_t>(token.lexeme.size()));
+    lines.push_back(static_cast<uint32_t>(token.line));
+}
+
+void TokenBuffer::append(const TokenBuffer &other, size_t from, int lineDelta)
+{
+    types.insert(types.end(), other.types.begin() + from, other.types.end());
+    offsets.insert(offsets.end(), other.offsets.begin() + from, other.offsets.end());
+    lengths.insert(lengths.end(), other.lengths.begin() + from, other.lengths.end());
+    size_t first = lines.size();
+    lines.insert(lines.end(), other.lines.begin() + from, other.lines.end());
+    if (lineDelta != 0)
+    {
+        for (size_t i = first; i < lines.size(); ++i)
+        {
+            lines[i] += lineDelta;
+        }
+    }
+}
+
+void TokenBuffer::fill(Lexer &lexer)
+{
+    reserve(source.size());
+    try
+    {
+        while (true)
+        {
+            Token token = lexer.getNextToken();
+            push(token);
+            if (token.type == TokenType::EOF_TOKEN)
+            {
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        fail(std::current_exception());
+    }
+}
+
+size_t TokenBuffer::lowerBound(size_t offset) const
+{
+    return static_cast<size_t>(std::lower_bound(offsets.begin(), offsets.end(), offset) - offsets.begin());
+}
+
+Token TokenBuffer::token(size_t index) const
+{
+    if (index >= size())
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        throw std::runtime_error("Token index " + std::to_string(index) + " is past the end of the token buffer.");
+    }
+
+    TokenType token_type = type(index);
+    std::string_view lexeme = source.substr(offsets[index], lengths[index]);
+    int line = static_cast<int>(lines[index]);
+
+    if (token_type == TokenType::NUMBER_LITERAL)
+    {
+        return Token(token_type, lexeme, Lexer::numberLiteral(lexeme, line), line);
+    }
+    if (token_type == TokenType::TRUE || token_type == TokenType::FALSE)
+    {
+        return Token(token_type, lexeme, token_type == TokenType::TRUE, line);
+    }
+    return Token(token_type, lexeme, line);
+}
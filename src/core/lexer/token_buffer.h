@@ -0,0 +1,40 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+#include "../common/token.h"
+
+class TokenBuffer
+{
+private:
+    std::string_view source;
+    std::vector<uint8_t> types;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    std::vector<uint32_t> lines;
+    std::exception_ptr error;
+
+public:
+    explicit TokenBuffer(std::string_view source);
+
+    void reserve(size_t bytes);
+    void push(const Token &token);
+    void append(const TokenBuffer &other, size_t from, int lineDelta);
+    void fail(std::exception_ptr exception) { error = exception; }
+    void fill(Lexer &lexer);
+
+    size_t size() const { return types.size(); }
+    bool failed() const { return error != nullptr; }
+    std::exception_ptr failure() const { return error; }
+    TokenType type(size_t index) const { return static_cast<TokenType>(types[index]); }
+    size_t offset(size_t index) const { return offsets[index]; }
+    size_t lowerBound(size_t offset) const;
+    Token token(size_t index) const;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "token_ring.h"
+
+static void backoff(unsigned &spins)
+{
+    if (++spins < 64)
+    {
+        return;
+    }
+    spins = 0;
+    std::this_thread::yield();
+}
+
+TokenRing::TokenRing(std::string_view source)
+    : lexer(source), head(0), tail(0), stopped(false), current(nullptr), index(0)
+{
+    producer = std::thread(&TokenRing::produce, this);
+}
+
+TokenRing::~TokenRing()
+{
+    stopped.store(true, std::memory_order_relaxed);
+    if (producer.joinable())
+    {
+        producer.join();
+    }
+}
+
+void TokenRing::produce()
+{
+    size_t position = head.load(std::memory_order_relaxed);
+    bool finished = false;
+
+    while (!finished)
+    {
+        unsigned spins = 0;
+        while (position - tail.load(std::memory_order_acquire) >= SLOT_COUNT)
+        {
+            if (stopped.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            backoff(spins);
+        }
+
+        Batch &batch = slots[position % SLOT_COUNT];
+        batch.tokens.clear();
+        batch.tokens.reserve(BATCH_SIZE);
+        batch.error = nullptr;
+
+        try
+        {
+            while (batch.tokens.size() < BATCH_SIZE)
+            {
+                batch.tokens.push_back(lexer.getNextToken());
+                if (batch.tokens.back().type == TokenType::EOF_TOKEN)
+                {
+                    finished = true;
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            batch.error = std::current_exception();
+            finished = true;
+        }
+
+        head.store(++position, std::memory_order_release);
+    }
+}
+
+Token TokenRing::next()
+{
+    while (true)
+    {
+        if (current && index < current->tokens.size())
+        {
+            const Token &token = current->tokens[index];
+            if (token.type != TokenType::EOF_TOKEN)
+            {
+                ++index;
+            }
+            return token;
+        }
+        if (current && current->error)
+        {
+            std::rethrow_exception(current->error);
+        }
+
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (current)
+        {
+            tail.store(++position, std::memory_order_release);
+        }
+
+        unsigned spins = 0;
+        while (head.load(std::memory_order_acquire) == position)
+        {
+            backoff(spins);
+        }
+        current = &slots[position % SLOT_COUNT];
+        index = 0;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef TOKEN_RING_H
+#define TOKEN_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "lexer.h"
+#include "../common/token.h"
+
+class TokenRing
+{
+private:
+    static constexpr size_t BATCH_SIZE = 1024;
+    static constexpr size_t SLOT_COUNT = 32;
+
+    struct Batch
+    {
+        std::vector<Token> tokens;
+        std::exception_ptr error;
+    };
+
+    Lexer lexer;
+    Batch slots[SLOT_COUNT];
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) std::atomic<bool> stopped;
+
+    const Batch *current;
+    size_t index;
+    std::thread producer;
+
+    void produce();
+
+public:
+    explicit TokenRing(std::string_view source);
+    TokenRing(const TokenRing &) = delete;
+    TokenRing &operator=(const TokenRing &) = delete;
+    ~TokenRing();
+
+    Token next();
+};
+
+#endif
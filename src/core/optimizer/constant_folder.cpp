@@ -0,0 +1,266 @@
+#include "constant_folder.h"
+#include "../runtime/evaluator.h"
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+ConstantFolder::ConstantFolder(Evaluator &evaluator) : evaluator(evaluator), arena(nullptr) {}
+
+void ConstantFolder::fold(ProgramNode *program)
+{
+    arena = &program->arena;
+    writtenSymbols.assign(program->symbols.size(), false);
+    for (const auto &stmt : program->statements)
+    {
+        collectWrittenNames(stmt);
+    }
+    fold(static_cast<ASTNode *>(program));
+}
+
+ASTNode *ConstantFolder::fold(ASTNode *node)
+{
+    return node ? visit_node(node, *this) : nullptr;
+}
+
+void ConstantFolder::markWritten(Symbol symbol)
+{
+    if (symbol >= writtenSymbols.size())
+    {
+        writtenSymbols.resize(symbol + 1, false);
+    }
+    writtenSymbols[symbol] = true;
+}
+
+void ConstantFolder::collectWrittenNames(ASTNode *node)
+{
+    switch (node->kind)
+    {
+    case NodeKind::FUNCTION_DECLARATION:
+    {
+        auto *funcDecl = static_cast<FunctionDeclaration *>(node);
+        for (const auto &param : funcDecl->parameters)
+        {
+            markWritten(param.symbol);
+        }
+        for (Symbol symbol : funcDecl->deferred_writes)
+        {
+            markWritten(symbol);
+        }
+        if (funcDecl->body)
+        {
+            collectWrittenNames(funcDecl->body);
+        }
+        break;
+    }
+    case NodeKind::BLOCK_STATEMENT:
+        for (const auto &stmt : static_cast<BlockStatement *>(node)->statements)
+        {
+            collectWrittenNames(stmt);
+        }
+        break;
+    case NodeKind::DECLARATION_STATEMENT:
+        markWritten(static_cast<DeclarationStatement *>(node)->target->symbol);
+        break;
+    case NodeKind::ASSIGNMENT_STATEMENT:
+        markWritten(static_cast<AssignmentStatement *>(node)->target->symbol);
+        break;
+    default:
+        break;
+    }
+}
+
+bool ConstantFolder::literalValue(ASTNode *node, Value &value) const
+{
+    switch (node->kind)
+    {
+    case NodeKind::STRING_LITERAL:
+        value = std::string(static_cast<StringLiteralExpr *>(node)->value);
+        return true;
+    case NodeKind::INTEGER_LITERAL:
+        value = static_cast<IntegerLiteralExpr *>(node)->value;
+        return true;
+    case NodeKind::NUMBER_LITERAL:
+        value = static_cast<NumberLiteralExpr *>(node)->value;
+        return true;
+    case NodeKind::BOOLEAN_LITERAL:
+        value = static_cast<BooleanLiteralExpr *>(node)->value;
+        return true;
+    default:
+        return false;
+    }
+}
+
+ASTNode *ConstantFolder::makeLiteral(const Value &value)
+{
+    if (auto *s = std::get_if<std::string>(&value))
+    {
+        return arena->make<StringLiteralExpr>(arena->copyString(*s));
+    }
+    if (auto *ll = std::get_if<long long>(&value))
+    {
+        return arena->make<IntegerLiteralExpr>(*ll);
+    }
+    if (auto *d = std::get_if<double>(&value))
+    {
+        return arena->make<NumberLiteralExpr>(*d);
+    }
+    if (auto *b = std::get_if<bool>(&value))
+    {
+        return arena->make<BooleanLiteralExpr>(*b);
+    }
+    return nullptr;
+}
+
+ASTNode *ConstantFolder::operator()(ProgramNode *node)
+{
+    for (auto &stmt : node->statements)
+    {
+        stmt = fold(stmt);
+    }
+    return node;
+}
+
+ASTNode *ConstantFolder::operator()(FunctionDeclaration *node)
+{
+    for (auto &param : node->parameters)
+    {
+        param.default_value = fold(param.default_value);
+    }
+    fold(node->body);
+    return node;
+}
+
+ASTNode *ConstantFolder::operator()(BlockStatement *node)
+{
+    for (auto &stmt : node->statements)
+    {
+        stmt = fold(stmt);
+    }
+    return node;
+}
+
+ASTNode *ConstantFolder::operator()(ReturnStatement *node)
+{
+    node->expression = fold(node->expression);
+    return node;
+}
+
+ASTNode *ConstantFolder::operator()(DeclarationStatement *node)
+{
+    node->value = fold(node->value);
+    return node;
+}
+
+ASTNode *ConstantFolder::operator()(AssignmentStatement *node)
+{
+    node->value = fold(node->value);
+    return node;
+}
+
+ASTNode *ConstantFolder::operator()(EchoStatement *node)
+{
+    node->expression = fold(node->expression);
+    return node;
+}
+
+ASTNode *ConstantFolder::operator()(VariableExpr *node)
+{
+    if (node->symbol < writtenSymbols.size() && writtenSymbols[node->symbol])
+    {
+        return node;
+    }
+
+    VariableSlot *slot = evaluator.findGlobal(node);
+    if (slot == nullptr)
+    {
+        return node;
+    }
+
+    ASTNode *literal = makeLiteral(slot->value);
+    return literal ? literal : node;
+}
+
+ASTNode *ConstantFolder::operator()(BinaryOpExpr *node)
+{
+    node->left = fold(node->left);
+    node->right = fold(node->right);
+
+    Value left;
+    Value right;
+    if (!literalValue(node->left, left) || !literalValue(node->right, right))
+    {
+        return node;
+    }
+
+    try
+    {
+        ASTNode *literal = makeLiteral(evaluator.applyBinaryOp(node->op, left, right));
+        return literal ? literal : node;
+    }
+    catch (const std::exception &)
+    {
+        return node;
+    }
+}
+
+ASTNode *ConstantFolder::operator()(UnaryOpExpr *node)
+{
+    node->right = fold(node->right);
+
+    Value right;
+    if (!literalValue(node->right, right))
+    {
+        return node;
+    }
+
+    try
+    {
+        ASTNode *literal = makeLiteral(evaluator.applyUnaryOp(node->op, right));
+        return literal ? literal : node;
+    }
+    catch (const std::exception &)
+    {
+        return node;
+    }
+}
+
+ASTNode *ConstantFolder::operator()(CallExpr *node)
+{
+    for (auto &arg : node->arguments)
+    {
+        arg = fold(arg);
+    }
+
+    auto *callee = node_cast<VariableExpr>(node->callee);
+    if (!callee)
+    {
+        return node;
+    }
+
+    const NativeFunctionInfo *native = evaluator.findNativeFunction(callee->name);
+    if (!native || !native->pure || native->cost == NativeCost::UNBOUNDED ||
+        node->arguments.size() < native->min_arity || node->arguments.size() > native->max_arity)
+    {
+        return node;
+    }
+
+    std::vector<Value> args(node->arguments.size());
+    for (size_t i = 0; i < node->arguments.size(); ++i)
+    {
+        if (!literalValue(node->arguments[i], args[i]))
+        {
+            return node;
+        }
+    }
+
+    try
+    {
+        ASTNode *literal = makeLiteral(native->function(args));
+        return literal ? literal : node;
+    }
+    catch (const std::exception &)
+    {
+        return node;
+    }
+}
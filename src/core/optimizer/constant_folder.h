@@ -0,0 +1,45 @@
+#ifndef CONSTANT_FOLDER_H
+#define CONSTANT_FOLDER_H
+
+#include <string_view>
+#include <vector>
+#include "../parser/ast.h"
+#include "../common/value.h"
+
+class Evaluator;
+
+class ConstantFolder
+{
+private:
+    Evaluator &evaluator;
+    AstArena *arena;
+    std::vector<bool> writtenSymbols;
+
+    void markWritten(Symbol symbol);
+    void collectWrittenNames(ASTNode *node);
+    bool literalValue(ASTNode *node, Value &value) const;
+    ASTNode *makeLiteral(const Value &value);
+
+public:
+    ConstantFolder(Evaluator &evaluator);
+
+    void fold(ProgramNode *program);
+    ASTNode *fold(ASTNode *node);
+
+    template <typename T>
+    ASTNode *operator()(T *node) { return node; }
+
+    ASTNode *operator()(ProgramNode *node);
+    ASTNode *operator()(FunctionDeclaration *node);
+    ASTNode *operator()(BlockStatement *node);
+    ASTNode *operator()(ReturnStatement *node);
+    ASTNode *operator()(DeclarationStatement *node);
+    ASTNode *operator()(AssignmentStatement *node);
+    ASTNode *operator()(EchoStatement *node);
+    ASTNode *operator()(VariableExpr *node);
+    ASTNode *operator()(BinaryOpExpr *node);
+    ASTNode *operator()(UnaryOpExpr *node);
+    ASTNode *operator()(CallExpr *node);
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+template <typename T>
+struct ArenaSpan
+{
+    T *items = nullptr;
+    uint32_t count = 0;
+
+    T *begin() const { return items; }
+    T *end() const { return items + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T &operator[](size_t index) const { return items[index]; }
+};
+
+class AstArena
+{
+private:
+    static constexpr size_t INITIAL_BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+    std::vector<std::unique_ptr<unsigned char[]>> blocks;
+    unsigned char *cursor = nullptr;
+    unsigned char *limit = nullptr;
+    size_t nextBlockSize = INITIAL_BLOCK_SIZE;
+
+    void *allocateSlow(size_t size, size_t alignment)
+    {
+        size_t block_size = nextBlockSize;
+        while (block_size < size + alignment)
+        {
+            block_size *= 2;
+        }
+        if (nextBlockSize < MAX_BLOCK_SIZE)
+        {
+            nextBlockSize *= 2;
+        }
+
+        blocks.emplace_back(new unsigned char[block_size]);
+        cursor = blocks.back().get();
+        limit = cursor + block_size;
+        return allocate(size, alignment);
+    }
+
+public:
+    AstArena() = default;
+    AstArena(const AstArena &) = delete;
+    AstArena &operator=(const AstArena &) = delete;
+
+    void *allocate(size_t size, size_t alignment)
+    {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+        if (cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(limit))
+        {
+            return allocateSlow(size, alignment);
+        }
+        cursor = reinterpret_cast<unsigned char *>(aligned + size);
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    template <typename T, typename... Args>
+    T *make(Args &&...args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    ArenaSpan<T> moveSpan(T *items, size_t count)
+    {
+        ArenaSpan<T> span;
+        if (count == 0)
+        {
+            return span;
+        }
+        span.items = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        span.count = static_cast<uint32_t>(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (&span.items[i]) T(std::move(items[i]));
+        }
+        return span;
+    }
+
+    template <typename T>
+    ArenaSpan<T> makeSpan(size_t count)
+    {
+        ArenaSpan<T> span;
+        if (count == 0)
+        {
+            return span;
+        }
+        span.items = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        span.count = static_cast<uint32_t>(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (&span.items[i]) T();
+        }
+        return span;
+    }
+
+    std::string_view copyString(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return std::string_view();
+        }
+        char *storage = static_cast<char *>(allocate(text.size(), 1));
+        std::memcpy(storage, text.data(), text.size());
+        return std::string_view(storage, text.size());
+    }
+
+    size_t blockCount() const { return blocks.size(); }
+};
+
+#endif
@@ -3,136 +3,331 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <stdexcept>
+#include "arena.h"
+#include "interner.h"
 #include "../common/token.h"
 #include "../common/value.h"
+#include "../common/source_buffer.h"
+
+enum class NodeKind : uint8_t
+{
+    PROGRAM,
+    FUNCTION_DECLARATION,
+    BLOCK_STATEMENT,
+    RETURN_STATEMENT,
+    DECLARATION_STATEMENT,
+    ASSIGNMENT_STATEMENT,
+    ECHO_STATEMENT,
+    STRING_LITERAL,
+    INTEGER_LITERAL,
+    NUMBER_LITERAL,
+    BOOLEAN_LITERAL,
+    VARIABLE,
+    BINARY_OP,
+    UNARY_OP,
+    CALL
+};
 
 struct ASTNode
 {
-    virtual ~ASTNode() = default;
+    const NodeKind kind;
+
+protected:
+    explicit ASTNode(NodeKind node_kind) : kind(node_kind) {}
 };
 
 struct StringLiteralExpr : public ASTNode
 {
-    std::string value;
-    StringLiteralExpr(std::string val) : value(std::move(val)) {}
+    static constexpr NodeKind KIND = NodeKind::STRING_LITERAL;
+    std::string_view value;
+    StringLiteralExpr(std::string_view val) : ASTNode(KIND), value(val) {}
+};
+
+struct IntegerLiteralExpr : public ASTNode
+{
+    static constexpr NodeKind KIND = NodeKind::INTEGER_LITERAL;
+    long long value;
+    IntegerLiteralExpr(long long val) : ASTNode(KIND), value(val) {}
 };
 
 struct NumberLiteralExpr : public ASTNode
 {
+    static constexpr NodeKind KIND = NodeKind::NUMBER_LITERAL;
     double value;
-    NumberLiteralExpr(double val) : value(val) {}
+    NumberLiteralExpr(double val) : ASTNode(KIND), value(val) {}
 };
 
 struct BooleanLiteralExpr : public ASTNode
 {
+    static constexpr NodeKind KIND = NodeKind::BOOLEAN_LITERAL;
     bool value;
-    BooleanLiteralExpr(bool val) : value(val) {}
+    BooleanLiteralExpr(bool val) : ASTNode(KIND), value(val) {}
+};
+
+enum class VariableScope : uint8_t
+{
+    UNRESOLVED,
+    GLOBAL,
+    LOCAL,
+    DYNAMIC
+};
+
+enum class ReadSpecialization : uint8_t
+{
+    UNINITIALIZED,
+    GENERIC,
+    LOCAL_INTEGER,
+    LOCAL_NUMBER,
+    LOCAL_BOOLEAN,
+    GLOBAL_INTEGER,
+    GLOBAL_NUMBER,
+    GLOBAL_BOOLEAN
 };
 
 struct VariableExpr : public ASTNode
 {
-    std::string name;
-    VariableExpr(std::string name) : name(std::move(name)) {}
+    static constexpr NodeKind KIND = NodeKind::VARIABLE;
+    VariableScope scope = VariableScope::UNRESOLVED;
+    ReadSpecialization specialization = ReadSpecialization::UNINITIALIZED;
+    uint32_t slot = 0;
+    std::string_view name;
+    Symbol symbol;
+    VariableExpr(std::string_view name, Symbol symbol) : ASTNode(KIND), name(name), symbol(symbol) {}
+};
+
+enum class BinarySpecialization : uint8_t
+{
+    UNINITIALIZED,
+    GENERIC,
+    INTEGER_ADD,
+    INTEGER_SUBTRACT,
+    INTEGER_MULTIPLY,
+    INTEGER_DIVIDE,
+    INTEGER_GREATER,
+    INTEGER_GREATER_EQUAL,
+    INTEGER_LESS,
+    INTEGER_LESS_EQUAL,
+    INTEGER_EQUAL,
+    INTEGER_NOT_EQUAL,
+    NUMBER_ADD,
+    NUMBER_SUBTRACT,
+    NUMBER_MULTIPLY,
+    NUMBER_DIVIDE,
+    NUMBER_GREATER,
+    NUMBER_GREATER_EQUAL,
+    NUMBER_LESS,
+    NUMBER_LESS_EQUAL,
+    NUMBER_EQUAL,
+    NUMBER_NOT_EQUAL,
+    STRING_CONCAT,
+    STRING_EQUAL,
+    STRING_NOT_EQUAL
 };
 
 struct BinaryOpExpr : public ASTNode
 {
+    static constexpr NodeKind KIND = NodeKind::BINARY_OP;
+    BinarySpecialization specialization = BinarySpecialization::UNINITIALIZED;
     TokenType op;
-    std::unique_ptr<ASTNode> left;
-    std::unique_ptr<ASTNode> right;
+    ASTNode *left;
+    ASTNode *right;
 
-    BinaryOpExpr(TokenType op_type, std::unique_ptr<ASTNode> left_expr, std::unique_ptr<ASTNode> right_expr)
-        : op(op_type), left(std::move(left_expr)), right(std::move(right_expr)) {}
+    BinaryOpExpr(TokenType op_type, ASTNode *left_expr, ASTNode *right_expr)
+        : ASTNode(KIND), op(op_type), left(left_expr), right(right_expr) {}
 };
 
 struct UnaryOpExpr : public ASTNode
 {
+    static constexpr NodeKind KIND = NodeKind::UNARY_OP;
     TokenType op;
-    std::unique_ptr<ASTNode> right;
+    ASTNode *right;
 
-    UnaryOpExpr(TokenType op_type, std::unique_ptr<ASTNode> right_expr)
-        : op(op_type), right(std::move(right_expr)) {}
+    UnaryOpExpr(TokenType op_type, ASTNode *right_expr)
+        : ASTNode(KIND), op(op_type), right(right_expr) {}
 };
 
 struct CallExpr : public ASTNode
 {
-    std::unique_ptr<ASTNode> callee;
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    static constexpr NodeKind KIND = NodeKind::CALL;
+    static constexpr uint32_t UNBOUND = static_cast<uint32_t>(-1);
+
+    ASTNode *callee;
+    ArenaSpan<ASTNode *> arguments;
+    uint32_t function_slot = UNBOUND;
+    bool arguments_need_check = true;
 
-    CallExpr(std::unique_ptr<ASTNode> callee_expr, std::vector<std::unique_ptr<ASTNode>> args)
-        : callee(std::move(callee_expr)), arguments(std::move(args)) {}
+    CallExpr(ASTNode *callee_expr, ArenaSpan<ASTNode *> args)
+        : ASTNode(KIND), callee(callee_expr), arguments(args) {}
 };
 
 struct AssignmentStatement : public ASTNode
 {
-    std::unique_ptr<VariableExpr> target;
-    std::unique_ptr<ASTNode> value;
+    static constexpr NodeKind KIND = NodeKind::ASSIGNMENT_STATEMENT;
+    VariableExpr *target;
+    ASTNode *value;
     bool is_declaration;
+    bool needs_type_check = true;
 
-    AssignmentStatement(std::unique_ptr<VariableExpr> target_var, std::unique_ptr<ASTNode> assigned_value, bool is_decl = false)
-        : target(std::move(target_var)), value(std::move(assigned_value)), is_declaration(is_decl) {}
+    AssignmentStatement(VariableExpr *target_var, ASTNode *assigned_value, bool is_decl = false)
+        : ASTNode(KIND), target(target_var), value(assigned_value), is_declaration(is_decl) {}
 };
 
 struct DeclarationStatement : public ASTNode
 {
+    static constexpr NodeKind KIND = NodeKind::DECLARATION_STATEMENT;
     TokenType declared_type;
-    std::unique_ptr<VariableExpr> target;
-    std::unique_ptr<ASTNode> value;
+    VariableExpr *target;
+    ASTNode *value;
+    bool needs_type_check = true;
 
-    DeclarationStatement(TokenType type, std::unique_ptr<VariableExpr> target_var, std::unique_ptr<ASTNode> initial_value)
-        : declared_type(type), target(std::move(target_var)), value(std::move(initial_value)) {}
+    DeclarationStatement(TokenType type, VariableExpr *target_var, ASTNode *initial_value)
+        : ASTNode(KIND), declared_type(type), target(target_var), value(initial_value) {}
 };
 
 struct EchoStatement : public ASTNode
 {
-    std::unique_ptr<ASTNode> expression;
+    static constexpr NodeKind KIND = NodeKind::ECHO_STATEMENT;
+    ASTNode *expression;
 
-    EchoStatement(std::unique_ptr<ASTNode> expr_to_echo) : expression(std::move(expr_to_echo)) {}
+    EchoStatement(ASTNode *expr_to_echo) : ASTNode(KIND), expression(expr_to_echo) {}
 };
 
 struct ReturnStatement : public ASTNode
 {
-    std::unique_ptr<ASTNode> expression;
-    ReturnStatement(std::unique_ptr<ASTNode> expr) : expression(std::move(expr)) {}
+    static constexpr NodeKind KIND = NodeKind::RETURN_STATEMENT;
+    ASTNode *expression;
+    ReturnStatement(ASTNode *expr) : ASTNode(KIND), expression(expr) {}
 };
 
 struct BlockStatement : public ASTNode
 {
-    std::vector<std::unique_ptr<ASTNode>> statements;
-    BlockStatement() = default;
+    static constexpr NodeKind KIND = NodeKind::BLOCK_STATEMENT;
+    ArenaSpan<ASTNode *> statements;
+    BlockStatement(ArenaSpan<ASTNode *> stmts) : ASTNode(KIND), statements(stmts) {}
 };
 
 struct ParameterDeclaration
 {
     TokenType declared_type;
-    std::string name;
-    std::unique_ptr<ASTNode> default_value;
+    std::string_view name;
+    Symbol symbol;
+    ASTNode *default_value;
+    uint32_t slot = 0;
+    bool default_needs_check = true;
 
-    ParameterDeclaration(TokenType type, std::string param_name, std::unique_ptr<ASTNode> def_val = nullptr)
-        : declared_type(type), name(std::move(param_name)), default_value(std::move(def_val)) {}
+    ParameterDeclaration(TokenType type, std::string_view param_name, Symbol param_symbol, ASTNode *def_val = nullptr)
+        : declared_type(type), name(param_name), symbol(param_symbol), default_value(def_val) {}
+};
 
-    ParameterDeclaration(const ParameterDeclaration &) = delete;
-    ParameterDeclaration &operator=(const ParameterDeclaration &) = delete;
-    ParameterDeclaration(ParameterDeclaration &&) = default;
-    ParameterDeclaration &operator=(ParameterDeclaration &&) = default;
+struct FunctionSignature
+{
+    ArenaSpan<DeclaredType> parameter_types;
+    DeclaredType return_type = DeclaredType::ANY;
 };
 
 struct FunctionDeclaration : public ASTNode
 {
-    std::string name;
-    std::vector<ParameterDeclaration> parameters;
+    static constexpr NodeKind KIND = NodeKind::FUNCTION_DECLARATION;
+    std::string_view name;
+    Symbol symbol;
+    ArenaSpan<ParameterDeclaration> parameters;
     TokenType return_type;
-    std::unique_ptr<BlockStatement> body;
+    BlockStatement *body;
+    ArenaSpan<Symbol> local_symbols;
+    FunctionSignature signature;
+    uint32_t function_slot = 0;
+    bool return_needs_check = true;
+    std::string_view deferred_body;
+    int deferred_line = 0;
+    uint32_t deferred_globals = 0;
+    ArenaSpan<Symbol> deferred_writes;
 
-    FunctionDeclaration(std::string func_name, std::vector<ParameterDeclaration> &&params, TokenType ret_type, std::unique_ptr<BlockStatement> func_body)
-        : name(std::move(func_name)), parameters(std::move(params)), return_type(ret_type), body(std::move(func_body)) {}
+    FunctionDeclaration(std::string_view func_name, Symbol func_symbol, ArenaSpan<ParameterDeclaration> params, TokenType ret_type, BlockStatement *func_body)
+        : ASTNode(KIND), name(func_name), symbol(func_symbol), parameters(params), return_type(ret_type), body(func_body) {}
 };
 
 struct ProgramNode : public ASTNode
 {
-    std::vector<std::unique_ptr<ASTNode>> statements;
-    ProgramNode() = default;
+    static constexpr NodeKind KIND = NodeKind::PROGRAM;
+    std::unique_ptr<SourceBuffer> source;
+    AstArena arena;
+    Interner symbols;
+    ArenaSpan<ASTNode *> statements;
+    ProgramNode() : ASTNode(KIND) {}
 };
 
-#endif
\ No newline at end of file
+template <typename T>
+T *node_cast(ASTNode *node)
+{
+    return node && node->kind == T::KIND ? static_cast<T *>(node) : nullptr;
+}
+
+template <typename T>
+const T *node_cast(const ASTNode *node)
+{
+    return node && node->kind == T::KIND ? static_cast<const T *>(node) : nullptr;
+}
+
+template <typename Visitor>
+decltype(auto) visit_node(ASTNode *node, Visitor &&visitor)
+{
+    switch (node->kind)
+    {
+    case NodeKind::PROGRAM:
+        return visitor(static_cast<ProgramNode *>(node));
+    case NodeKind::FUNCTION_DECLARATION:
+        return visitor(static_cast<FunctionDeclaration *>(node));
+    case NodeKind::BLOCK_STATEMENT:
+        return visitor(static_cast<BlockStatement *>(node));
+    case NodeKind::RETURN_STATEMENT:
+        return visitor(static_cast<ReturnStatement *>(node));
+    case NodeKind::DECLARATION_STATEMENT:
+        return visitor(static_cast<DeclarationStatement *>(node));
+    case NodeKind::ASSIGNMENT_STATEMENT:
+        return visitor(static_cast<AssignmentStatement *>(node));
+    case NodeKind::ECHO_STATEMENT:
+        return visitor(static_cast<EchoStatement *>(node));
+    case NodeKind::STRING_LITERAL:
+        return visitor(static_cast<StringLiteralExpr *>(node));
+    case NodeKind::INTEGER_LITERAL:
+        return visitor(static_cast<IntegerLiteralExpr *>(node));
+    case NodeKind::NUMBER_LITERAL:
+        return visitor(static_cast<NumberLiteralExpr *>(node));
+    case NodeKind::BOOLEAN_LITERAL:
+        return visitor(static_cast<BooleanLiteralExpr *>(node));
+    case NodeKind::VARIABLE:
+        return visitor(static_cast<VariableExpr *>(node));
+    case NodeKind::BINARY_OP:
+        return visitor(static_cast<BinaryOpExpr *>(node));
+    case NodeKind::UNARY_OP:
+        return visitor(static_cast<UnaryOpExpr *>(node));
+    case NodeKind::CALL:
+        return visitor(static_cast<CallExpr *>(node));
+    }
+    throw std::runtime_error("Unknown AST node kind.");
+}
+
+static_assert(std::is_trivially_destructible_v<StringLiteralExpr> &&
+                  std::is_trivially_destructible_v<IntegerLiteralExpr> &&
+                  std::is_trivially_destructible_v<NumberLiteralExpr> &&
+                  std::is_trivially_destructible_v<BooleanLiteralExpr> &&
+                  std::is_trivially_destructible_v<VariableExpr> &&
+                  std::is_trivially_destructible_v<BinaryOpExpr> &&
+                  std::is_trivially_destructible_v<UnaryOpExpr> &&
+                  std::is_trivially_destructible_v<CallExpr> &&
+                  std::is_trivially_destructible_v<AssignmentStatement> &&
+                  std::is_trivially_destructible_v<DeclarationStatement> &&
+                  std::is_trivially_destructible_v<EchoStatement> &&
+                  std::is_trivially_destructible_v<ReturnStatement> &&
+                  std::is_trivially_destructible_v<BlockStatement> &&
+                  std::is_trivially_destructible_v<ParameterDeclaration> &&
+                  std::is_trivially_destructible_v<FunctionDeclaration>,
+              "Arena-allocated AST nodes must not need destructors.");
+
+#endif
@@ -0,0 +1,95 @@
+#include "interner.h"
+#include <cstring>
+
+static constexpr size_t INITIAL_CAPACITY = 256;
+
+Interner::Interner() : table(INITIAL_CAPACITY) {}
+
+uint32_t Interner::hashOf(std::string_view text)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ text.size();
+    const char *p = text.data();
+    size_t remaining = text.size();
+    while (remaining >= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        p += 8;
+        remaining -= 8;
+    }
+    if (remaining > 0)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, p, remaining);
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+    }
+    hash ^= hash >> 32;
+    return static_cast<uint32_t>(hash) | 1u;
+}
+
+Symbol Interner::find(std::string_view text) const
+{
+    uint32_t hash = hashOf(text);
+    size_t mask = table.size() - 1;
+    for (size_t index = hash & mask;; index = (index + 1) & mask)
+    {
+        const Entry &entry = table[index];
+        if (entry.hash == 0)
+        {
+            return NONE;
+        }
+        if (entry.hash == hash && names[entry.symbol] == text)
+        {
+            return entry.symbol;
+        }
+    }
+}
+
+Symbol Interner::intern(std::string_view text)
+{
+    uint32_t hash = hashOf(text);
+    size_t mask = table.size() - 1;
+    size_t index = hash & mask;
+    for (;; index = (index + 1) & mask)
+    {
+        const Entry &entry = table[index];
+        if (entry.hash == 0)
+        {
+            break;
+        }
+        if (entry.hash == hash && names[entry.symbol] == text)
+        {
+            return entry.symbol;
+        }
+    }
+
+    Symbol symbol = static_cast<Symbol>(names.size());
+    names.push_back(text);
+    table[index] = {hash, symbol};
+    if (names.size() * 2 > table.size())
+    {
+        grow();
+    }
+    return symbol;
+}
+
+void Interner::grow()
+{
+    std::vector<Entry> old = std::move(table);
+    table.assign(old.size() * 2, Entry{});
+    size_t mask = table.size() - 1;
+    for (const Entry &entry : old)
+    {
+        if (entry.hash == 0)
+        {
+            continue;
+        }
+        size_t index = entry.hash & mask;
+        while (table[index].hash != 0)
+        {
+            index = (index + 1) & mask;
+        }
+        table[index] = entry;
+    }
+}
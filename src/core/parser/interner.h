@@ -0,0 +1,38 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using Symbol = uint32_t;
+
+class Interner
+{
+private:
+    struct Entry
+    {
+        uint32_t hash = 0;
+        uint32_t symbol = 0;
+    };
+
+    std::vector<Entry> table;
+    std::vector<std::string_view> names;
+
+    static uint32_t hashOf(std::string_view text);
+    void grow();
+
+public:
+    static constexpr Symbol NONE = static_cast<Symbol>(-1);
+
+    Interner();
+
+    Symbol intern(std::string_view text);
+    Symbol find(std::string_view text) const;
+    std::string_view name(Symbol symbol) const { return names[symbol]; }
+    std::string_view canonical(std::string_view text) { return names[intern(text)]; }
+    size_t size() const { return names.size(); }
+};
+
+#endif
@@ -3,17 +3,121 @@
 #include <string>
 #include <stdexcept>
 
-Parser::Parser(Lexer &lexer) : lexer(lexer), currentToken(lexer.getNextToken())
+static bool isTypeKeyword(TokenType type)
 {
+    return type == TokenType::STRING_KEYWORD ||
+           type == TokenType::INTEGER_KEYWORD ||
+           type == TokenType::NUMBER_KEYWORD ||
+           type == TokenType::BOOLEAN_KEYWORD;
+}
+
+struct PrecedenceTable
+{
+    uint8_t levels[static_cast<size_t>(TokenType::UNKNOWN) + 1] = {};
+
+    constexpr void set(TokenType type, uint8_t level) { levels[static_cast<size_t>(type)] = level; }
+
+    constexpr PrecedenceTable()
+    {
+        set(TokenType::DOT, 1);
+        set(TokenType::OR, 2);
+        set(TokenType::AND, 3);
+        set(TokenType::PIPE, 4);
+        set(TokenType::EQUAL_EQUAL, 5);
+        set(TokenType::BANG_EQUAL, 5);
+        set(TokenType::LESS, 6);
+        set(TokenType::LESS_EQUAL, 6);
+        set(TokenType::GREATER, 6);
+        set(TokenType::GREATER_EQUAL, 6);
+        set(TokenType::PLUS, 7);
+        set(TokenType::MINUS, 7);
+        set(TokenType::STAR, 8);
+        set(TokenType::SLASH, 8);
+    }
+};
+
+static constexpr PrecedenceTable binaryPrecedence;
+
+Parser::Parser(Lexer &lexer) : lexer(&lexer), tokens(nullptr), ring(nullptr), position(0), currentToken(lexer.getNextToken()), arena(nullptr), symbols(nullptr), lazyFunctionBodies(false)
+{
+}
+
+Parser::Parser(const TokenBuffer &tokens) : lexer(nullptr), tokens(&tokens), ring(nullptr), position(0), currentToken(tokens.token(0)), arena(nullptr), symbols(nullptr), lazyFunctionBodies(false)
+{
+}
+
+Parser::Parser(TokenRing &ring) : lexer(nullptr), tokens(nullptr), ring(&ring), position(0), currentToken(ring.next()), arena(nullptr), symbols(nullptr), lazyFunctionBodies(false)
+{
+}
+
+ArenaSpan<ASTNode *> Parser::takeNodes(size_t mark)
+{
+    ArenaSpan<ASTNode *> span = arena->moveSpan(nodeScratch.data() + mark, nodeScratch.size() - mark);
+    nodeScratch.resize(mark);
+    return span;
+}
+
+VariableExpr *Parser::makeVariable(std::string_view name)
+{
+    return make<VariableExpr>(name, symbols->intern(name));
+}
+
+std::string_view Parser::stringValue(std::string_view lexeme)
+{
+    if (lexeme.find('\\') == std::string_view::npos)
+    {
+        return symbols->canonical(lexeme.substr(1, lexeme.size() - 2));
+    }
+    char *storage = static_cast<char *>(arena->allocate(lexeme.size(), 1));
+    return symbols->canonical(Lexer::decodeString(lexeme, storage));
+}
+
+ArenaSpan<ASTNode *> Parser::parseArguments()
+{
+    size_t mark = nodeScratch.size();
+    consume(TokenType::LEFT_PAREN);
+    if (currentToken.type != TokenType::RIGHT_PAREN)
+    {
+        do
+        {
+            ASTNode *arg = parseExpression();
+            nodeScratch.push_back(arg);
+            if (currentToken.type == TokenType::COMMA)
+            {
+                consume(TokenType::COMMA);
+            }
+            else
+            {
+                break;
+            }
+        } while (true);
+    }
+    consume(TokenType::RIGHT_PAREN);
+    return takeNodes(mark);
 }
 
 void Parser::advance()
 {
-    currentToken = lexer.getNextToken();
+    if (tokens)
+    {
+        if (position + 1 < tokens->size() || tokens->failed())
+        {
+            ++position;
+        }
+        currentToken = tokens->token(position);
+    }
+    else if (ring)
+    {
+        currentToken = ring->next();
+    }
+    else
+    {
+        currentToken = lexer->getNextToken();
+    }
 
     if (currentToken.type == TokenType::UNKNOWN)
     {
-        throw std::runtime_error("Lexer returned UNKNOWN token: \"" + currentToken.lexeme + "\" at line " + std::to_string(currentToken.line) + ".");
+        throw std::runtime_error("Lexer returned UNKNOWN token: \"" + std::string(currentToken.lexeme) + "\" at line " + std::to_string(currentToken.line) + ".");
     }
 }
 
@@ -44,11 +148,11 @@ TokenType Parser::consumeTypeKeyword()
                              currentToken.toString() + " at line " + std::to_string(currentToken.line) + ".");
 }
 
-std::string Parser::consumeIdentifier()
+std::string_view Parser::consumeIdentifier()
 {
     if (currentToken.type == TokenType::IDENTIFIER)
     {
-        std::string name = currentToken.lexeme;
+        std::string_view name = currentToken.lexeme;
         advance();
         return name;
     }
@@ -56,50 +160,48 @@ std::string Parser::consumeIdentifier()
                              currentToken.toString() + " at line " + std::to_string(currentToken.line) + ".");
 }
 
-std::unique_ptr<ASTNode> Parser::parsePrimaryExpression()
+ASTNode *Parser::parsePrimaryExpression()
 {
     if (currentToken.type == TokenType::STRING_LITERAL)
     {
-        std::string value = std::get<std::string>(currentToken.literal);
+        std::string_view value = stringValue(currentToken.lexeme);
         consume(TokenType::STRING_LITERAL);
-        return std::make_unique<StringLiteralExpr>(value);
+        return make<StringLiteralExpr>(value);
     }
     else if (currentToken.type == TokenType::NUMBER_LITERAL)
     {
-        double value;
         if (std::holds_alternative<long long>(currentToken.literal))
         {
-            value = static_cast<double>(std::get<long long>(currentToken.literal));
-        }
-        else
-        {
-            value = std::get<double>(currentToken.literal);
+            long long value = std::get<long long>(currentToken.literal);
+            consume(TokenType::NUMBER_LITERAL);
+            return make<IntegerLiteralExpr>(value);
         }
+        double value = std::get<double>(currentToken.literal);
         consume(TokenType::NUMBER_LITERAL);
-        return std::make_unique<NumberLiteralExpr>(value);
+        return make<NumberLiteralExpr>(value);
     }
     else if (currentToken.type == TokenType::TRUE)
     {
         bool value = std::get<bool>(currentToken.literal);
         consume(TokenType::TRUE);
-        return std::make_unique<BooleanLiteralExpr>(value);
+        return make<BooleanLiteralExpr>(value);
     }
     else if (currentToken.type == TokenType::FALSE)
     {
         bool value = std::get<bool>(currentToken.literal);
         consume(TokenType::FALSE);
-        return std::make_unique<BooleanLiteralExpr>(value);
+        return make<BooleanLiteralExpr>(value);
     }
     else if (currentToken.type == TokenType::IDENTIFIER)
     {
-        std::string name = currentToken.lexeme;
+        std::string_view name = currentToken.lexeme;
         consume(TokenType::IDENTIFIER);
-        return std::make_unique<VariableExpr>(name);
+        return makeVariable(name);
     }
     else if (currentToken.type == TokenType::LEFT_PAREN)
     {
         consume(TokenType::LEFT_PAREN);
-        std::unique_ptr<ASTNode> expr = parseExpression();
+        ASTNode *expr = parseExpression();
         consume(TokenType::RIGHT_PAREN);
         return expr;
     }
@@ -108,36 +210,19 @@ std::unique_ptr<ASTNode> Parser::parsePrimaryExpression()
                              currentToken.toString() + " at line " + std::to_string(currentToken.line) + ".");
 }
 
-std::unique_ptr<ASTNode> Parser::parseCall()
+ASTNode *Parser::parseCall()
 {
-    std::unique_ptr<ASTNode> expr = parsePrimaryExpression();
+    ASTNode *expr = parsePrimaryExpression();
 
     while (currentToken.type == TokenType::LEFT_PAREN)
     {
-        consume(TokenType::LEFT_PAREN);
-        std::vector<std::unique_ptr<ASTNode>> args;
-        if (currentToken.type != TokenType::RIGHT_PAREN)
-        {
-            do
-            {
-                args.push_back(parseExpression());
-                if (currentToken.type == TokenType::COMMA)
-                {
-                    consume(TokenType::COMMA);
-                }
-                else
-                {
-                    break;
-                }
-            } while (true);
-        }
-        consume(TokenType::RIGHT_PAREN);
-        expr = std::make_unique<CallExpr>(std::move(expr), std::move(args));
+        ArenaSpan<ASTNode *> args = parseArguments();
+        expr = make<CallExpr>(expr, args);
     }
     return expr;
 }
 
-std::unique_ptr<ASTNode> Parser::parseUnary()
+ASTNode *Parser::parseUnary()
 {
     if (currentToken.type == TokenType::BANG ||
         currentToken.type == TokenType::MINUS ||
@@ -145,196 +230,103 @@ std::unique_ptr<ASTNode> Parser::parseUnary()
     {
         TokenType op = currentToken.type;
         advance();
-        std::unique_ptr<ASTNode> right = parseUnary();
-        return std::make_unique<UnaryOpExpr>(op, std::move(right));
+        ASTNode *right = parseUnary();
+        return make<UnaryOpExpr>(op, right);
     }
     return parseCall();
 }
 
-std::unique_ptr<ASTNode> Parser::parseFactor()
-{
-    std::unique_ptr<ASTNode> left = parseUnary();
-
-    while (currentToken.type == TokenType::STAR || currentToken.type == TokenType::SLASH)
-    {
-        TokenType op = currentToken.type;
-        advance();
-        std::unique_ptr<ASTNode> right = parseUnary();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseTerm()
+ASTNode *Parser::parseBinary(int minPrecedence)
 {
-    std::unique_ptr<ASTNode> left = parseFactor();
+    ASTNode *left = parseUnary();
 
-    while (currentToken.type == TokenType::PLUS || currentToken.type == TokenType::MINUS)
+    while (true)
     {
-        TokenType op = currentToken.type;
-        advance();
-        std::unique_ptr<ASTNode> right = parseFactor();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseComparison()
-{
-    std::unique_ptr<ASTNode> left = parseTerm();
-
-    while (currentToken.type == TokenType::GREATER || currentToken.type == TokenType::GREATER_EQUAL ||
-           currentToken.type == TokenType::LESS || currentToken.type == TokenType::LESS_EQUAL)
-    {
-        TokenType op = currentToken.type;
-        advance();
-        std::unique_ptr<ASTNode> right = parseTerm();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseEquality()
-{
-    std::unique_ptr<ASTNode> left = parseComparison();
-
-    while (currentToken.type == TokenType::BANG_EQUAL || currentToken.type == TokenType::EQUAL_EQUAL)
-    {
-        TokenType op = currentToken.type;
-        advance();
-        std::unique_ptr<ASTNode> right = parseComparison();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseBitwiseOr()
-{
-    std::unique_ptr<ASTNode> left = parseEquality();
-
-    while (currentToken.type == TokenType::PIPE)
-    {
-        TokenType op = currentToken.type;
-        advance();
-        std::unique_ptr<ASTNode> right = parseEquality();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalAnd()
-{
-    std::unique_ptr<ASTNode> left = parseBitwiseOr();
-
-    while (currentToken.type == TokenType::AND)
-    {
-        TokenType op = currentToken.type;
-        advance();
-        std::unique_ptr<ASTNode> right = parseBitwiseOr();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalOr()
-{
-    std::unique_ptr<ASTNode> left = parseLogicalAnd();
-
-    while (currentToken.type == TokenType::OR)
-    {
-        TokenType op = currentToken.type;
-        advance();
-        std::unique_ptr<ASTNode> right = parseLogicalAnd();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseConcatenation()
-{
-    std::unique_ptr<ASTNode> left = parseLogicalOr();
+        int precedence = binaryPrecedence.levels[static_cast<size_t>(currentToken.type)];
+        if (precedence < minPrecedence)
+        {
+            return left;
+        }
 
-    while (currentToken.type == TokenType::DOT)
-    {
         TokenType op = currentToken.type;
         advance();
-        std::unique_ptr<ASTNode> right = parseLogicalOr();
-        left = std::make_unique<BinaryOpExpr>(op, std::move(left), std::move(right));
+        ASTNode *right = parseBinary(precedence + 1);
+        left = make<BinaryOpExpr>(op, left, right);
     }
-    return left;
 }
 
-std::unique_ptr<ASTNode> Parser::parseExpression()
+ASTNode *Parser::parseExpression()
 {
-    return parseConcatenation();
+    return parseBinary(1);
 }
 
-std::unique_ptr<EchoStatement> Parser::parseEchoStatement()
+EchoStatement *Parser::parseEchoStatement()
 {
     consume(TokenType::ECHO);
-    std::unique_ptr<ASTNode> expr = parseExpression();
+    ASTNode *expr = parseExpression();
     consume(TokenType::SEMICOLON);
-    return std::make_unique<EchoStatement>(std::move(expr));
+    return make<EchoStatement>(expr);
 }
 
-std::unique_ptr<DeclarationStatement> Parser::parsePublicDeclarationStatement()
+DeclarationStatement *Parser::parsePublicDeclarationStatement()
 {
     consume(TokenType::PUBLIC);
     TokenType declared_type_token = consumeTypeKeyword();
-    std::unique_ptr<VariableExpr> var_target = std::make_unique<VariableExpr>(consumeIdentifier());
+    VariableExpr *var_target = makeVariable(consumeIdentifier());
 
-    std::unique_ptr<ASTNode> value_expr = nullptr;
+    ASTNode *value_expr = nullptr;
     if (currentToken.type == TokenType::EQUAL)
     {
         consume(TokenType::EQUAL);
         value_expr = parseExpression();
     }
     consume(TokenType::SEMICOLON);
-    return std::make_unique<DeclarationStatement>(declared_type_token, std::move(var_target), std::move(value_expr));
+    return make<DeclarationStatement>(declared_type_token, var_target, value_expr);
 }
 
-std::unique_ptr<DeclarationStatement> Parser::parseLocalDeclarationStatement()
+DeclarationStatement *Parser::parseLocalDeclarationStatement()
 {
     TokenType declared_type_token = consumeTypeKeyword();
-    std::unique_ptr<VariableExpr> var_target = std::make_unique<VariableExpr>(consumeIdentifier());
+    VariableExpr *var_target = makeVariable(consumeIdentifier());
 
-    std::unique_ptr<ASTNode> value_expr = nullptr;
+    ASTNode *value_expr = nullptr;
     if (currentToken.type == TokenType::EQUAL)
     {
         consume(TokenType::EQUAL);
         value_expr = parseExpression();
     }
     consume(TokenType::SEMICOLON);
-    return std::make_unique<DeclarationStatement>(declared_type_token, std::move(var_target), std::move(value_expr));
+    return make<DeclarationStatement>(declared_type_token, var_target, value_expr);
 }
 
-std::unique_ptr<ReturnStatement> Parser::parseReturnStatement()
+ReturnStatement *Parser::parseReturnStatement()
 {
     consume(TokenType::RETURN);
-    std::unique_ptr<ASTNode> expr = nullptr;
+    ASTNode *expr = nullptr;
     if (currentToken.type != TokenType::SEMICOLON)
     {
         expr = parseExpression();
     }
     consume(TokenType::SEMICOLON);
-    return std::make_unique<ReturnStatement>(std::move(expr));
+    return make<ReturnStatement>(expr);
 }
 
-std::unique_ptr<BlockStatement> Parser::parseBlock()
+BlockStatement *Parser::parseBlock()
 {
-    auto block = std::make_unique<BlockStatement>();
+    size_t mark = nodeScratch.size();
     consume(TokenType::LEFT_BRACE);
     while (currentToken.type != TokenType::RIGHT_BRACE && currentToken.type != TokenType::EOF_TOKEN)
     {
-        block->statements.push_back(parseStatement());
+        ASTNode *stmt = parseStatement();
+        nodeScratch.push_back(stmt);
     }
     consume(TokenType::RIGHT_BRACE);
-    return block;
+    return make<BlockStatement>(takeNodes(mark));
 }
 
-std::vector<ParameterDeclaration> Parser::parseParameterList()
+ArenaSpan<ParameterDeclaration> Parser::parseParameterList()
 {
-    std::vector<ParameterDeclaration> parameters;
+    size_t mark = parameterScratch.size();
     consume(TokenType::LEFT_PAREN);
 
     if (currentToken.type != TokenType::RIGHT_PAREN)
@@ -342,15 +334,15 @@ std::vector<ParameterDeclaration> Parser::parseParameterList()
         do
         {
             TokenType param_type = consumeTypeKeyword();
-            std::string param_name = consumeIdentifier();
-            std::unique_ptr<ASTNode> default_value = nullptr;
+            std::string_view param_name = consumeIdentifier();
+            ASTNode *default_value = nullptr;
 
             if (currentToken.type == TokenType::EQUAL)
             {
                 consume(TokenType::EQUAL);
                 default_value = parseExpression();
             }
-            parameters.emplace_back(param_type, param_name, std::move(default_value));
+            parameterScratch.emplace_back(param_type, param_name, symbols->intern(param_name), default_value);
 
             if (currentToken.type == TokenType::COMMA)
             {
@@ -363,22 +355,100 @@ std::vector<ParameterDeclaration> Parser::parseParameterList()
         } while (true);
     }
     consume(TokenType::RIGHT_PAREN);
+    ArenaSpan<ParameterDeclaration> parameters = arena->moveSpan(parameterScratch.data() + mark, parameterScratch.size() - mark);
+    parameterScratch.erase(parameterScratch.begin() + mark, parameterScratch.end());
     return parameters;
 }
 
-std::unique_ptr<FunctionDeclaration> Parser::parseFunctionDeclaration()
+FunctionSignature Parser::describeSignature(ArenaSpan<ParameterDeclaration> parameters, TokenType return_type)
+{
+    FunctionSignature signature;
+    signature.parameter_types = arena->makeSpan<DeclaredType>(parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        signature.parameter_types[i] = tokenTypeToDeclaredType(parameters[i].declared_type);
+    }
+    signature.return_type = tokenTypeToDeclaredType(return_type);
+    return signature;
+}
+
+FunctionDeclaration *Parser::parseFunctionDeclaration()
 {
     consume(TokenType::FUNCTION);
-    std::string func_name = consumeIdentifier();
-    std::vector<ParameterDeclaration> parameters = parseParameterList();
+    std::string_view func_name = consumeIdentifier();
+    ArenaSpan<ParameterDeclaration> parameters = parseParameterList();
     consume(TokenType::COLON);
     TokenType return_type = consumeTypeKeyword();
-    std::unique_ptr<BlockStatement> body = parseBlock();
 
-    return std::make_unique<FunctionDeclaration>(func_name, std::move(parameters), return_type, std::move(body));
+    if (lazyFunctionBodies)
+    {
+        FunctionDeclaration *node = make<FunctionDeclaration>(func_name, symbols->intern(func_name), parameters, return_type, nullptr);
+        node->signature = describeSignature(parameters, return_type);
+        skipFunctionBody(node);
+        return node;
+    }
+
+    BlockStatement *body = parseBlock();
+    FunctionDeclaration *node = make<FunctionDeclaration>(func_name, symbols->intern(func_name), parameters, return_type, body);
+    node->signature = describeSignature(parameters, return_type);
+    return node;
+}
+
+void Parser::skipFunctionBody(FunctionDeclaration *node)
+{
+    if (currentToken.type != TokenType::LEFT_BRACE)
+    {
+        consume(TokenType::LEFT_BRACE);
+    }
+
+    const char *body_start = currentToken.lexeme.data();
+    node->deferred_line = currentToken.line;
+
+    size_t mark = symbolScratch.size();
+    TokenType previous = currentToken.type;
+    std::string_view previous_lexeme;
+    int depth = 0;
+
+    while (true)
+    {
+        if (currentToken.type == TokenType::LEFT_BRACE)
+        {
+            ++depth;
+        }
+        else if (currentToken.type == TokenType::RIGHT_BRACE)
+        {
+            --depth;
+        }
+        else if (currentToken.type == TokenType::EOF_TOKEN)
+        {
+            consume(TokenType::RIGHT_BRACE);
+        }
+        else if (currentToken.type == TokenType::IDENTIFIER && isTypeKeyword(previous))
+        {
+            symbolScratch.push_back(symbols->intern(currentToken.lexeme));
+        }
+        else if (currentToken.type == TokenType::EQUAL && previous == TokenType::IDENTIFIER)
+        {
+            symbolScratch.push_back(symbols->intern(previous_lexeme));
+        }
+
+        if (depth == 0)
+        {
+            break;
+        }
+        previous = currentToken.type;
+        previous_lexeme = currentToken.lexeme;
+        advance();
+    }
+
+    const char *body_end = currentToken.lexeme.data() + currentToken.lexeme.size();
+    node->deferred_body = std::string_view(body_start, static_cast<size_t>(body_end - body_start));
+    node->deferred_writes = arena->moveSpan(symbolScratch.data() + mark, symbolScratch.size() - mark);
+    symbolScratch.resize(mark);
+    advance();
 }
 
-std::unique_ptr<ASTNode> Parser::parseStatement()
+ASTNode *Parser::parseStatement()
 {
     if (currentToken.type == TokenType::ECHO)
     {
@@ -401,46 +471,28 @@ std::unique_ptr<ASTNode> Parser::parseStatement()
     }
     else if (currentToken.type == TokenType::IDENTIFIER)
     {
-        std::string identifier_lexeme = currentToken.lexeme;
+        std::string_view identifier_lexeme = currentToken.lexeme;
         int identifier_line = currentToken.line;
         advance();
 
         if (currentToken.type == TokenType::EQUAL)
         {
-            std::unique_ptr<VariableExpr> var_target = std::make_unique<VariableExpr>(identifier_lexeme);
+            VariableExpr *var_target = makeVariable(identifier_lexeme);
             consume(TokenType::EQUAL);
-            std::unique_ptr<ASTNode> value_expr = parseExpression();
+            ASTNode *value_expr = parseExpression();
             consume(TokenType::SEMICOLON);
-            return std::make_unique<AssignmentStatement>(std::move(var_target), std::move(value_expr), false);
+            return make<AssignmentStatement>(var_target, value_expr, false);
         }
         else if (currentToken.type == TokenType::LEFT_PAREN)
         {
-            std::unique_ptr<VariableExpr> callee_expr = std::make_unique<VariableExpr>(identifier_lexeme);
-
-            consume(TokenType::LEFT_PAREN);
-            std::vector<std::unique_ptr<ASTNode>> args;
-            if (currentToken.type != TokenType::RIGHT_PAREN)
-            {
-                do
-                {
-                    args.push_back(parseExpression());
-                    if (currentToken.type == TokenType::COMMA)
-                    {
-                        consume(TokenType::COMMA);
-                    }
-                    else
-                    {
-                        break;
-                    }
-                } while (true);
-            }
-            consume(TokenType::RIGHT_PAREN);
+            VariableExpr *callee_expr = makeVariable(identifier_lexeme);
+            ArenaSpan<ASTNode *> args = parseArguments();
             consume(TokenType::SEMICOLON);
-            return std::make_unique<CallExpr>(std::move(callee_expr), std::move(args));
+            return make<CallExpr>(callee_expr, args);
         }
         else
         {
-            throw std::runtime_error("Unexpected token after identifier '" + identifier_lexeme + "'. Expected '=' or '(', but got " +
+            throw std::runtime_error("Unexpected token after identifier '" + std::string(identifier_lexeme) + "'. Expected '=' or '(', but got " +
                                      currentToken.toString() + " at line " + std::to_string(identifier_line) + ".");
         }
     }
@@ -449,7 +501,7 @@ std::unique_ptr<ASTNode> Parser::parseStatement()
                              currentToken.toString() + " at line " + std::to_string(currentToken.line) + ".");
 }
 
-std::unique_ptr<ASTNode> Parser::parseTopLevelStatement()
+ASTNode *Parser::parseTopLevelStatement()
 {
     if (currentToken.type == TokenType::FUNCTION)
     {
@@ -461,13 +513,30 @@ std::unique_ptr<ASTNode> Parser::parseTopLevelStatement()
     }
 }
 
+BlockStatement *Parser::parseDeferredBody(ProgramNode &program)
+{
+    arena = &program.arena;
+    symbols = &program.symbols;
+    BlockStatement *body = parseBlock();
+    if (currentToken.type != TokenType::EOF_TOKEN)
+    {
+        consume(TokenType::EOF_TOKEN);
+    }
+    return body;
+}
+
 std::unique_ptr<ProgramNode> Parser::parseProgram()
 {
     auto program = std::make_unique<ProgramNode>();
+    arena = &program->arena;
+    symbols = &program->symbols;
 
+    size_t mark = nodeScratch.size();
     while (currentToken.type != TokenType::EOF_TOKEN)
     {
-        program->statements.push_back(parseTopLevelStatement());
+        ASTNode *stmt = parseTopLevelStatement();
+        nodeScratch.push_back(stmt);
     }
+    program->statements = takeNodes(mark);
     return program;
 }
\ No newline at end of file
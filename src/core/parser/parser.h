@@ -5,48 +5,70 @@
 #include <string>
 #include <memory>
 #include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../lexer/token_ring.h"
 #include "../parser/ast.h"
 #include "../common/token.h"
 
 class Parser
 {
 private:
-    Lexer &lexer;
+    Lexer *lexer;
+    const TokenBuffer *tokens;
+    TokenRing *ring;
+    size_t position;
     Token currentToken;
+    AstArena *arena;
+    Interner *symbols;
+    std::vector<ASTNode *> nodeScratch;
+    std::vector<ParameterDeclaration> parameterScratch;
+    std::vector<Symbol> symbolScratch;
+    bool lazyFunctionBodies;
+
+    template <typename T, typename... Args>
+    T *make(Args &&...args)
+    {
+        return arena->make<T>(std::forward<Args>(args)...);
+    }
+
+    ArenaSpan<ASTNode *> takeNodes(size_t mark);
+    VariableExpr *makeVariable(std::string_view name);
+    std::string_view stringValue(std::string_view lexeme);
+    ArenaSpan<ASTNode *> parseArguments();
 
     void advance();
     void consume(TokenType type);
     TokenType consumeTypeKeyword();
-    std::string consumeIdentifier();
-
-    std::unique_ptr<ASTNode> parsePrimaryExpression();
-    std::unique_ptr<ASTNode> parseCall();
-    std::unique_ptr<ASTNode> parseUnary();
-    std::unique_ptr<ASTNode> parseFactor();
-    std::unique_ptr<ASTNode> parseTerm();
-    std::unique_ptr<ASTNode> parseComparison();
-    std::unique_ptr<ASTNode> parseEquality();
-    std::unique_ptr<ASTNode> parseBitwiseOr();
-    std::unique_ptr<ASTNode> parseLogicalAnd();
-    std::unique_ptr<ASTNode> parseLogicalOr();
-    std::unique_ptr<ASTNode> parseConcatenation();
-    std::unique_ptr<ASTNode> parseExpression();
-
-    std::unique_ptr<EchoStatement> parseEchoStatement();
-    std::unique_ptr<DeclarationStatement> parsePublicDeclarationStatement();
-    std::unique_ptr<DeclarationStatement> parseLocalDeclarationStatement();
-    std::unique_ptr<ReturnStatement> parseReturnStatement();
-    std::unique_ptr<BlockStatement> parseBlock();
-    std::vector<ParameterDeclaration> parseParameterList();
-    std::unique_ptr<FunctionDeclaration> parseFunctionDeclaration();
-
-    std::unique_ptr<ASTNode> parseStatement();
-    std::unique_ptr<ASTNode> parseTopLevelStatement();
+    std::string_view consumeIdentifier();
+
+    ASTNode *parsePrimaryExpression();
+    ASTNode *parseCall();
+    ASTNode *parseUnary();
+    ASTNode *parseBinary(int minPrecedence);
+    ASTNode *parseExpression();
+
+    EchoStatement *parseEchoStatement();
+    DeclarationStatement *parsePublicDeclarationStatement();
+    DeclarationStatement *parseLocalDeclarationStatement();
+    ReturnStatement *parseReturnStatement();
+    BlockStatement *parseBlock();
+    void skipFunctionBody(FunctionDeclaration *node);
+    ArenaSpan<ParameterDeclaration> parseParameterList();
+    FunctionSignature describeSignature(ArenaSpan<ParameterDeclaration> parameters, TokenType return_type);
+    FunctionDeclaration *parseFunctionDeclaration();
+
+    ASTNode *parseStatement();
+    ASTNode *parseTopLevelStatement();
 
 public:
     Parser(Lexer &lexer);
+    Parser(const TokenBuffer &tokens);
+    Parser(TokenRing &ring);
+
+    void setLazyFunctionBodies(bool lazy) { lazyFunctionBodies = lazy; }
 
     std::unique_ptr<ProgramNode> parseProgram();
+    BlockStatement *parseDeferredBody(ProgramNode &program);
 };
 
 #endif
\ No newline at end of file
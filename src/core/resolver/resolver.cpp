@@ -0,0 +1,396 @@
+#include "resolver.h"
+#include <stdexcept>
+
+static uint32_t insertSlot(GlobalTable &table, std::string_view name)
+{
+    auto it = table.slots.find(name);
+    if (it != table.slots.end())
+    {
+        return it->second;
+    }
+    uint32_t slot = static_cast<uint32_t>(table.names.size());
+    table.slots.emplace(std::string(name), slot);
+    table.names.emplace_back(name);
+    return slot;
+}
+
+uint32_t GlobalTable::slotFor(std::string_view name)
+{
+    size_t count = names.size();
+    uint32_t slot = insertSlot(*this, name);
+    if (names.size() != count)
+    {
+        clearSymbols();
+    }
+    return slot;
+}
+
+uint32_t GlobalTable::slotFor(Symbol symbol, std::string_view name)
+{
+    if (symbol >= symbolSlots.size())
+    {
+        symbolSlots.resize(symbol + 1, UNCACHED);
+    }
+    uint32_t &cached = symbolSlots[symbol];
+    if (cached >= ABSENT)
+    {
+        cached = insertSlot(*this, name);
+    }
+    return cached;
+}
+
+const uint32_t *GlobalTable::find(std::string_view name) const
+{
+    auto it = slots.find(name);
+    return it != slots.end() ? &it->second : nullptr;
+}
+
+const uint32_t *GlobalTable::find(Symbol symbol, std::string_view name)
+{
+    if (symbol >= symbolSlots.size())
+    {
+        symbolSlots.resize(symbol + 1, UNCACHED);
+    }
+    uint32_t &cached = symbolSlots[symbol];
+    if (cached == UNCACHED)
+    {
+        const uint32_t *slot = find(name);
+        cached = slot ? *slot : ABSENT;
+    }
+    return cached == ABSENT ? nullptr : &cached;
+}
+
+void GlobalTable::clearSymbols()
+{
+    symbolSlots.assign(symbolSlots.size(), UNCACHED);
+}
+
+Resolver::Resolver(GlobalTable &globals, GlobalTable &functions)
+    : globals(globals), functions(functions), arena(nullptr), currentFunction(nullptr), visibleGlobals(UINT32_MAX) {}
+
+void Resolver::resolve(ProgramNode *node)
+{
+    arena = &node->arena;
+    collectGlobals(node);
+    heldSymbols.clear();
+    for (const auto &stmt : node->statements)
+    {
+        collectHeldSymbols(stmt, false);
+    }
+    for (const auto &stmt : node->statements)
+    {
+        resolveStatement(stmt);
+    }
+}
+
+void Resolver::resolveFunction(FunctionDeclaration *node)
+{
+    visibleGlobals = node->deferred_globals;
+    resolveFunctionDeclaration(node);
+    visibleGlobals = UINT32_MAX;
+}
+
+void Resolver::collectGlobals(ProgramNode *node)
+{
+    for (const auto &stmt : node->statements)
+    {
+        if (auto *decl = node_cast<DeclarationStatement>(stmt))
+        {
+            globals.slotFor(decl->target->symbol, decl->target->name);
+        }
+        else if (auto *assign = node_cast<AssignmentStatement>(stmt))
+        {
+            globals.slotFor(assign->target->symbol, assign->target->name);
+        }
+    }
+}
+
+void Resolver::collectHeldSymbols(ASTNode *node, bool in_function)
+{
+    switch (node->kind)
+    {
+    case NodeKind::FUNCTION_DECLARATION:
+    {
+        auto *funcDecl = static_cast<FunctionDeclaration *>(node);
+        for (const auto &param : funcDecl->parameters)
+        {
+            hold(param.symbol);
+        }
+        for (Symbol symbol : funcDecl->deferred_writes)
+        {
+            hold(symbol);
+        }
+        if (funcDecl->body)
+        {
+            collectHeldSymbols(funcDecl->body, true);
+        }
+        break;
+    }
+    case NodeKind::BLOCK_STATEMENT:
+        for (const auto &stmt : static_cast<BlockStatement *>(node)->statements)
+        {
+            collectHeldSymbols(stmt, in_function);
+        }
+        break;
+    case NodeKind::DECLARATION_STATEMENT:
+        if (in_function)
+        {
+            hold(static_cast<DeclarationStatement *>(node)->target->symbol);
+        }
+        break;
+    case NodeKind::ASSIGNMENT_STATEMENT:
+        if (in_function)
+        {
+            hold(static_cast<AssignmentStatement *>(node)->target->symbol);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void Resolver::resolveStatement(ASTNode *node)
+{
+    switch (node->kind)
+    {
+    case NodeKind::FUNCTION_DECLARATION:
+        resolveFunctionDeclaration(static_cast<FunctionDeclaration *>(node));
+        break;
+    case NodeKind::BLOCK_STATEMENT:
+        for (const auto &stmt : static_cast<BlockStatement *>(node)->statements)
+        {
+            resolveStatement(stmt);
+        }
+        break;
+    case NodeKind::RETURN_STATEMENT:
+        resolveExpression(static_cast<ReturnStatement *>(node)->expression);
+        break;
+    case NodeKind::DECLARATION_STATEMENT:
+    {
+        auto *decl = static_cast<DeclarationStatement *>(node);
+        resolveExpression(decl->value);
+        resolveDeclaration(decl->target);
+        break;
+    }
+    case NodeKind::ASSIGNMENT_STATEMENT:
+    {
+        auto *assign = static_cast<AssignmentStatement *>(node);
+        resolveExpression(assign->value);
+        resolveAssignment(assign->target);
+        break;
+    }
+    case NodeKind::ECHO_STATEMENT:
+        resolveExpression(static_cast<EchoStatement *>(node)->expression);
+        break;
+    default:
+        resolveExpression(node);
+        break;
+    }
+}
+
+void Resolver::resolveExpression(ASTNode *node)
+{
+    if (!node)
+    {
+        return;
+    }
+
+    switch (node->kind)
+    {
+    case NodeKind::VARIABLE:
+        resolveRead(static_cast<VariableExpr *>(node));
+        break;
+    case NodeKind::BINARY_OP:
+    {
+        auto *binOp = static_cast<BinaryOpExpr *>(node);
+        resolveExpression(binOp->left);
+        resolveExpression(binOp->right);
+        break;
+    }
+    case NodeKind::UNARY_OP:
+        resolveExpression(static_cast<UnaryOpExpr *>(node)->right);
+        break;
+    case NodeKind::CALL:
+    {
+        auto *call = static_cast<CallExpr *>(node);
+        if (auto *callee = node_cast<VariableExpr>(call->callee))
+        {
+            call->function_slot = functions.slotFor(callee->symbol, callee->name);
+        }
+        else
+        {
+            resolveExpression(call->callee);
+        }
+        for (const auto &arg : call->arguments)
+        {
+            resolveExpression(arg);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void Resolver::resolveFunctionDeclaration(FunctionDeclaration *node)
+{
+    node->function_slot = functions.slotFor(node->symbol, node->name);
+
+    FunctionDeclaration *enclosing = currentFunction;
+    std::vector<Symbol> enclosing_symbols = std::move(localSymbols);
+    std::vector<bool> enclosing_dynamic = std::move(dynamicLocals);
+    for (Symbol symbol : enclosing_symbols)
+    {
+        localSlots[symbol] = NO_LOCAL;
+    }
+
+    currentFunction = node;
+    localSymbols.clear();
+    dynamicLocals.clear();
+
+    for (auto &param : node->parameters)
+    {
+        resolveExpression(param.default_value);
+        uint32_t slot = findLocal(param.symbol);
+        param.slot = slot != NO_LOCAL ? slot : declareLocal(param.symbol);
+    }
+
+    if (node->body)
+    {
+        for (const auto &stmt : node->body->statements)
+        {
+            resolveStatement(stmt);
+        }
+    }
+    else
+    {
+        node->deferred_globals = static_cast<uint32_t>(globals.names.size());
+    }
+
+    node->local_symbols = arena->moveSpan(localSymbols.data(), localSymbols.size());
+    for (Symbol symbol : localSymbols)
+    {
+        localSlots[symbol] = NO_LOCAL;
+    }
+
+    currentFunction = enclosing;
+    localSymbols = std::move(enclosing_symbols);
+    dynamicLocals = std::move(enclosing_dynamic);
+    for (uint32_t slot = 0; slot < localSymbols.size(); ++slot)
+    {
+        localSlots[localSymbols[slot]] = slot;
+    }
+}
+
+void Resolver::resolveRead(VariableExpr *var)
+{
+    if (!currentFunction)
+    {
+        var->scope = VariableScope::GLOBAL;
+        var->slot = globals.slotFor(var->symbol, var->name);
+        return;
+    }
+
+    uint32_t local_slot = findLocal(var->symbol);
+    if (local_slot != NO_LOCAL && !dynamicLocals[local_slot])
+    {
+        var->scope = VariableScope::LOCAL;
+        var->slot = local_slot;
+        return;
+    }
+
+    if (local_slot == NO_LOCAL && !isHeld(var->symbol))
+    {
+        if (const uint32_t *global_slot = findGlobal(var))
+        {
+            var->scope = VariableScope::GLOBAL;
+            var->slot = *global_slot;
+            return;
+        }
+    }
+    var->scope = VariableScope::DYNAMIC;
+    var->slot = local_slot != NO_LOCAL ? local_slot : 0;
+}
+
+void Resolver::resolveAssignment(VariableExpr *var)
+{
+    if (!currentFunction)
+    {
+        var->scope = VariableScope::GLOBAL;
+        var->slot = globals.slotFor(var->symbol, var->name);
+        return;
+    }
+
+    uint32_t local_slot = findLocal(var->symbol);
+    if (local_slot != NO_LOCAL && !dynamicLocals[local_slot])
+    {
+        var->scope = VariableScope::LOCAL;
+        var->slot = local_slot;
+        return;
+    }
+
+    if (local_slot == NO_LOCAL)
+    {
+        local_slot = declareLocal(var->symbol);
+        dynamicLocals[local_slot] = true;
+    }
+    var->scope = VariableScope::DYNAMIC;
+    var->slot = local_slot;
+}
+
+void Resolver::resolveDeclaration(VariableExpr *var)
+{
+    if (!currentFunction)
+    {
+        var->scope = VariableScope::GLOBAL;
+        var->slot = globals.slotFor(var->symbol, var->name);
+        return;
+    }
+
+    uint32_t local_slot = findLocal(var->symbol);
+    if (local_slot == NO_LOCAL)
+    {
+        local_slot = declareLocal(var->symbol);
+    }
+    dynamicLocals[local_slot] = false;
+    var->scope = VariableScope::LOCAL;
+    var->slot = local_slot;
+}
+
+const uint32_t *Resolver::findGlobal(const VariableExpr *var)
+{
+    const uint32_t *slot = globals.find(var->symbol, var->name);
+    return slot && *slot < visibleGlobals ? slot : nullptr;
+}
+
+uint32_t Resolver::findLocal(Symbol symbol) const
+{
+    return symbol < localSlots.size() ? localSlots[symbol] : NO_LOCAL;
+}
+
+uint32_t Resolver::declareLocal(Symbol symbol)
+{
+    uint32_t slot = static_cast<uint32_t>(localSymbols.size());
+    if (symbol >= localSlots.size())
+    {
+        localSlots.resize(symbol + 1, NO_LOCAL);
+    }
+    localSymbols.push_back(symbol);
+    dynamicLocals.push_back(false);
+    localSlots[symbol] = slot;
+    return slot;
+}
+
+void Resolver::hold(Symbol symbol)
+{
+    if (symbol >= heldSymbols.size())
+    {
+        heldSymbols.resize(symbol + 1, false);
+    }
+    heldSymbols[symbol] = true;
+}
+
+bool Resolver::isHeld(Symbol symbol) const
+{
+    return symbol < heldSymbols.size() && heldSymbols[symbol];
+}
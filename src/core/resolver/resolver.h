@@ -0,0 +1,64 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "../parser/ast.h"
+
+struct GlobalTable
+{
+    static constexpr uint32_t UNCACHED = UINT32_MAX;
+    static constexpr uint32_t ABSENT = UINT32_MAX - 1;
+
+    std::map<std::string, uint32_t, std::less<>> slots;
+    std::vector<std::string> names;
+    std::vector<uint32_t> symbolSlots;
+
+    uint32_t slotFor(std::string_view name);
+    uint32_t slotFor(Symbol symbol, std::string_view name);
+    const uint32_t *find(std::string_view name) const;
+    const uint32_t *find(Symbol symbol, std::string_view name);
+    void clearSymbols();
+};
+
+class Resolver
+{
+private:
+    GlobalTable &globals;
+    GlobalTable &functions;
+    static constexpr uint32_t NO_LOCAL = UINT32_MAX;
+
+    AstArena *arena;
+    FunctionDeclaration *currentFunction;
+    std::vector<uint32_t> localSlots;
+    std::vector<Symbol> localSymbols;
+    std::vector<bool> dynamicLocals;
+    std::vector<bool> heldSymbols;
+    uint32_t visibleGlobals;
+
+    void collectGlobals(ProgramNode *node);
+    void collectHeldSymbols(ASTNode *node, bool in_function);
+    void hold(Symbol symbol);
+    bool isHeld(Symbol symbol) const;
+    void resolveStatement(ASTNode *node);
+    void resolveExpression(ASTNode *node);
+    void resolveFunctionDeclaration(FunctionDeclaration *node);
+
+    void resolveRead(VariableExpr *var);
+    void resolveAssignment(VariableExpr *var);
+    void resolveDeclaration(VariableExpr *var);
+    uint32_t findLocal(Symbol symbol) const;
+    uint32_t declareLocal(Symbol symbol);
+    const uint32_t *findGlobal(const VariableExpr *var);
+
+public:
+    Resolver(GlobalTable &globals, GlobalTable &functions);
+
+    void resolve(ProgramNode *node);
+    void resolveFunction(FunctionDeclaration *node);
+};
+
+#endif
@@ -1,4 +1,10 @@
 #include "evaluator.h"
+#include "../optimizer/constant_folder.h"
+#include "../lexer/lexer.h"
+#include "../parser/parser.h"
+#include "../compiler/compiler.h"
+#include "../vm/vm.h"
+#include "../utilities/debugger.h"
 #include <iostream>
 #include <stdexcept>
 #include <cmath>
@@ -6,98 +12,203 @@
 #include <variant>
 #include <limits>
 
-Evaluator::Evaluator()
+Evaluator::Evaluator() : folder(*this), resolver(globalTable, functionTable), checker(*this)
 {
-    enterScope();
+    frames.reserve(64);
+    localSlots.reserve(256);
+    argumentStack.reserve(64);
 }
 
 void Evaluator::registerNativeFunction(const std::string &name, NativeFunction func)
 {
-    nativeFunctions[name] = std::move(func);
+    NativeFunctionInfo info;
+    info.function = std::move(func);
+    registerNativeFunction(name, std::move(info));
+}
+
+void Evaluator::registerNativeFunction(const std::string &name, NativeFunctionInfo info)
+{
+    nativeFunctions[name] = std::move(info);
+}
+
+const NativeFunctionInfo *Evaluator::findNativeFunction(std::string_view name) const
+{
+    auto it = nativeFunctions.find(name);
+    return it != nativeFunctions.end() ? &it->second : nullptr;
 }
 
 void Evaluator::registerConstant(const std::string &name, Value value)
 {
-    if (findVariableInScope(name).first != nullptr)
+    if (findGlobal(name) != nullptr)
     {
         throw std::runtime_error("Internal error: Attempted to re-register existing constant/variable '" + name + "'.");
     }
 
-    scopeStack.front()[name] = {value, valueTypeToDeclaredType(value)};
+    uint32_t slot = globalTable.slotFor(name);
+    globals.resize(globalTable.names.size());
+    globals[slot] = {value, valueTypeToDeclaredType(value), true};
 }
 
-void Evaluator::interpret(std::unique_ptr<ProgramNode> ast)
+void Evaluator::setEngine(ExecutionEngine selected_engine)
 {
-    evaluate(ast.get());
+    engine = selected_engine;
 }
 
-Value Evaluator::evaluate(ASTNode *node)
+void Evaluator::interpret(std::unique_ptr<ProgramNode> ast)
 {
-    if (!node)
+    if (engine == ExecutionEngine::VM)
     {
-        return std::monostate{};
+        std::unique_ptr<CompiledProgram> compiled = compile(ast.get());
+        run(*compiled);
+        return;
     }
 
-    if (auto *prog = dynamic_cast<ProgramNode *>(node))
-    {
-        return evaluateProgramNode(prog);
-    }
-    else if (auto *funcDecl = dynamic_cast<FunctionDeclaration *>(node))
-    {
-        return evaluateFunctionDeclaration(funcDecl);
-    }
-    else if (auto *block = dynamic_cast<BlockStatement *>(node))
-    {
-        return evaluateBlockStatement(block);
-    }
-    else if (auto *ret = dynamic_cast<ReturnStatement *>(node))
-    {
-        return evaluateReturnStatement(ret);
-    }
-    else if (auto *decl = dynamic_cast<DeclarationStatement *>(node))
-    {
-        return evaluateDeclarationStatement(decl);
-    }
-    else if (auto *assign = dynamic_cast<AssignmentStatement *>(node))
-    {
-        return evaluateAssignmentStatement(assign);
-    }
-    else if (auto *echo = dynamic_cast<EchoStatement *>(node))
-    {
-        return evaluateEchoStatement(echo);
-    }
-    else if (auto *strLit = dynamic_cast<StringLiteralExpr *>(node))
+    prepare(ast.get());
+
+    auto execute_start = std::chrono::steady_clock::now();
+    evaluate(ast.get());
+    stats.execute_ms = elapsed_ms(execute_start);
+}
+
+void Evaluator::prepare(ProgramNode *ast)
+{
+    program = ast;
+    globalTable.clearSymbols();
+    functionTable.clearSymbols();
+    folder.fold(program);
+    resolver.resolve(program);
+    globals.resize(globalTable.names.size());
+    bindFunctions();
+    checker.check(program);
+}
+
+std::unique_ptr<CompiledProgram> Evaluator::compile(ProgramNode *ast)
+{
+    prepare(ast);
+
+    auto compile_start = std::chrono::steady_clock::now();
+    Compiler compiler(ast->symbols);
+    std::unique_ptr<CompiledProgram> compiled = compiler.compile(ast);
+    compiled->global_names = globalTable.names;
+    compiled->function_names = functionTable.names;
+    compiled->type_checks = stats.type_checks;
+    compiled->type_checks_elided = stats.type_checks_elided;
+    stats.compile_ms = elapsed_ms(compile_start);
+
+    debug_print_bytecode(*compiled);
+    return compiled;
+}
+
+static bool tableAccepts(const GlobalTable &table, const std::vector<std::string> &names)
+{
+    if (table.names.size() > names.size())
     {
-        return evaluateStringLiteralExpr(strLit);
+        return false;
     }
-    else if (auto *numLit = dynamic_cast<NumberLiteralExpr *>(node))
+    for (size_t slot = 0; slot < names.size(); ++slot)
     {
-        return evaluateNumberLiteralExpr(numLit);
+        if (slot < table.names.size() ? table.names[slot] != names[slot] : table.find(names[slot]) != nullptr)
+        {
+            return false;
+        }
     }
-    else if (auto *boolLit = dynamic_cast<BooleanLiteralExpr *>(node))
+    return true;
+}
+
+bool Evaluator::load(const CompiledProgram &compiled)
+{
+    if (!tableAccepts(globalTable, compiled.global_names) || !tableAccepts(functionTable, compiled.function_names))
     {
-        return evaluateBooleanLiteralExpr(boolLit);
+        return false;
     }
-    else if (auto *var = dynamic_cast<VariableExpr *>(node))
+
+    for (const auto &name : compiled.global_names)
     {
-        return evaluateVariableExpr(var);
+        globalTable.slotFor(name);
     }
-    else if (auto *binOp = dynamic_cast<BinaryOpExpr *>(node))
+    for (const auto &name : compiled.function_names)
     {
-        return evaluateBinaryOpExpr(binOp);
+        functionTable.slotFor(name);
     }
-    else if (auto *unaryOp = dynamic_cast<UnaryOpExpr *>(node))
+    globals.resize(globalTable.names.size());
+    bindFunctions();
+    stats.type_checks = compiled.type_checks;
+    stats.type_checks_elided = compiled.type_checks_elided;
+
+    debug_print_bytecode(compiled);
+    return true;
+}
+
+void Evaluator::run(CompiledProgram &compiled)
+{
+    auto execute_start = std::chrono::steady_clock::now();
+    VM vm(*this);
+    vm.run(compiled);
+    stats.execute_ms = elapsed_ms(execute_start);
+}
+
+void Evaluator::bindFunctions()
+{
+    for (size_t slot = functions.size(); slot < functionTable.names.size(); ++slot)
     {
-        return evaluateUnaryOpExpr(unaryOp);
+        functions.push_back({findNativeFunction(functionTable.names[slot]), nullptr});
     }
-    else if (auto *call = dynamic_cast<CallExpr *>(node))
+}
+
+void Evaluator::materializeFunction(FunctionDeclaration *function)
+{
+    Lexer lexer(function->deferred_body);
+    lexer.seek(0, function->deferred_line);
+    Parser parser(lexer);
+    function->body = parser.parseDeferredBody(*program);
+
+    folder.fold(function->body);
+    resolver.resolveFunction(function);
+    bindFunctions();
+    checker.checkFunction(function);
+}
+
+Value Evaluator::evaluate(ASTNode *node)
+{
+    if (!node)
     {
-        return evaluateCallExpr(call);
+        return std::monostate{};
     }
-    else
+
+    switch (node->kind)
     {
-        throw std::runtime_error("Unknown AST node type during evaluation.");
+    case NodeKind::PROGRAM:
+        return evaluateProgramNode(static_cast<ProgramNode *>(node));
+    case NodeKind::FUNCTION_DECLARATION:
+        return evaluateFunctionDeclaration(static_cast<FunctionDeclaration *>(node));
+    case NodeKind::BLOCK_STATEMENT:
+        return evaluateBlockStatement(static_cast<BlockStatement *>(node));
+    case NodeKind::RETURN_STATEMENT:
+        return evaluateReturnStatement(static_cast<ReturnStatement *>(node));
+    case NodeKind::DECLARATION_STATEMENT:
+        return evaluateDeclarationStatement(static_cast<DeclarationStatement *>(node));
+    case NodeKind::ASSIGNMENT_STATEMENT:
+        return evaluateAssignmentStatement(static_cast<AssignmentStatement *>(node));
+    case NodeKind::ECHO_STATEMENT:
+        return evaluateEchoStatement(static_cast<EchoStatement *>(node));
+    case NodeKind::STRING_LITERAL:
+        return evaluateStringLiteralExpr(static_cast<StringLiteralExpr *>(node));
+    case NodeKind::INTEGER_LITERAL:
+        return evaluateIntegerLiteralExpr(static_cast<IntegerLiteralExpr *>(node));
+    case NodeKind::NUMBER_LITERAL:
+        return evaluateNumberLiteralExpr(static_cast<NumberLiteralExpr *>(node));
+    case NodeKind::BOOLEAN_LITERAL:
+        return evaluateBooleanLiteralExpr(static_cast<BooleanLiteralExpr *>(node));
+    case NodeKind::VARIABLE:
+        return evaluateVariableExpr(static_cast<VariableExpr *>(node));
+    case NodeKind::BINARY_OP:
+        return evaluateBinaryOpExpr(static_cast<BinaryOpExpr *>(node));
+    case NodeKind::UNARY_OP:
+        return evaluateUnaryOpExpr(static_cast<UnaryOpExpr *>(node));
+    case NodeKind::CALL:
+        return evaluateCallExpr(static_cast<CallExpr *>(node));
     }
+    throw std::runtime_error("Unknown AST node type during evaluation.");
 }
 
 Value Evaluator::callNativeFunctionByName(const std::string &name, const std::vector<Value> &args)
@@ -107,15 +218,44 @@ Value Evaluator::callNativeFunctionByName(const std::string &name, const std::ve
     {
         throw std::runtime_error("Runtime error: Attempted to call unknown native function '" + name + "'.");
     }
-    return it->second(args);
+    return it->second.function(args);
 }
 
 Value Evaluator::getConstant(const std::string &name)
 {
-    auto [val_ptr, type_ptr] = findVariableInScope(name);
-    if (val_ptr == nullptr)
+    VariableSlot *slot = findGlobal(name);
+    if (slot == nullptr)
     {
         throw std::runtime_error("Runtime error: Undefined constant '" + name + "'.");
     }
-    return *val_ptr;
+    return slot->value;
+}
+
+std::string Evaluator::registrationKey() const
+{
+    std::ostringstream key;
+    for (const auto &[name, info] : nativeFunctions)
+    {
+        key << "native " << name << ' ' << info.pure << ' ' << static_cast<int>(info.cost) << ' ' << info.min_arity << ' ' << info.max_arity;
+        for (DeclaredType type : info.parameter_types)
+        {
+            key << ' ' << static_cast<int>(type);
+        }
+        key << ' ' << info.definition.size() << ':' << info.definition << '\n';
+    }
+    for (size_t slot = 0; slot < globals.size(); ++slot)
+    {
+        if (globals[slot].defined)
+        {
+            std::ostringstream value;
+            value << globals[slot].value;
+            key << "constant " << globalTable.names[slot] << ' ' << static_cast<int>(globals[slot].type) << ' ' << value.str().size() << ':' << value.str() << '\n';
+        }
+    }
+    return key.str();
+}
+
+ExecutionStats &Evaluator::getStats()
+{
+    return stats;
 }
\ No newline at end of file
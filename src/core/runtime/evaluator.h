@@ -2,17 +2,44 @@
 #define EVALUATOR_H
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <map>
 #include <stack>
 #include "../parser/ast.h"
+#include "../resolver/resolver.h"
+#include "../optimizer/constant_folder.h"
+#include "../checker/type_checker.h"
 #include "../common/value.h"
+#include "../utilities/stats.h"
 #include <functional>
 #include <stdexcept>
 
+struct CompiledProgram;
+
 using NativeFunction = std::function<Value(const std::vector<Value> &)>;
 
+enum class NativeCost
+{
+    CONSTANT,
+    LINEAR,
+    UNBOUNDED
+};
+
+struct NativeFunctionInfo
+{
+    static constexpr size_t VARIADIC = static_cast<size_t>(-1);
+
+    NativeFunction function;
+    bool pure = false;
+    size_t min_arity = 0;
+    size_t max_arity = VARIADIC;
+    std::vector<DeclaredType> parameter_types;
+    NativeCost cost = NativeCost::UNBOUNDED;
+    std::string definition;
+};
+
 class FunctionReturnException : public std::runtime_error
 {
 public:
@@ -20,12 +47,82 @@ public:
     FunctionReturnException(Value val) : std::runtime_error("Function return"), returnValue(std::move(val)) {}
 };
 
+struct VariableSlot
+{
+    Value value;
+    DeclaredType type = DeclaredType::ANY;
+    bool defined = false;
+};
+
+struct LocalFrame
+{
+    FunctionDeclaration *function;
+    size_t base;
+};
+
+struct FunctionEntry
+{
+    const NativeFunctionInfo *native = nullptr;
+    FunctionDeclaration *declaration = nullptr;
+};
+
+enum class BinaryOperator : uint8_t
+{
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    GREATER,
+    GREATER_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    EQUAL,
+    NOT_EQUAL,
+    AND,
+    OR,
+    BIT_OR,
+    CONCAT,
+    COUNT
+};
+
+BinaryOperator binaryOperatorFor(TokenType op);
+Value integerArithmetic(BinaryOperator op, long long left, long long right);
+
+enum class ControlFlow
+{
+    NORMAL,
+    RETURN
+};
+
+enum class ExecutionEngine
+{
+    AST,
+    VM
+};
+
 class Evaluator
 {
+    friend class VM;
+    friend class ConstantFolder;
+    friend class TypeChecker;
+
 private:
-    std::vector<std::map<std::string, std::pair<Value, DeclaredType>>> scopeStack;
-    std::map<std::string, NativeFunction> nativeFunctions;
-    std::map<std::string, FunctionDeclaration *> userFunctions;
+    ExecutionEngine engine = ExecutionEngine::VM;
+    ExecutionStats stats;
+    GlobalTable globalTable;
+    std::vector<VariableSlot> globals;
+    std::vector<LocalFrame> frames;
+    std::vector<VariableSlot> localSlots;
+    std::vector<Value> argumentStack;
+    ControlFlow controlFlow = ControlFlow::NORMAL;
+    Value returnValue;
+    std::map<std::string, NativeFunctionInfo, std::less<>> nativeFunctions;
+    GlobalTable functionTable;
+    std::vector<FunctionEntry> functions;
+    ConstantFolder folder;
+    Resolver resolver;
+    TypeChecker checker;
+    ProgramNode *program = nullptr;
 
     Value evaluate(ASTNode *node);
     Value evaluateProgramNode(ProgramNode *node);
@@ -37,6 +134,7 @@ private:
     Value evaluateFunctionDeclaration(FunctionDeclaration *node);
 
     Value evaluateStringLiteralExpr(StringLiteralExpr *node);
+    Value evaluateIntegerLiteralExpr(IntegerLiteralExpr *node);
     Value evaluateNumberLiteralExpr(NumberLiteralExpr *node);
     Value evaluateBooleanLiteralExpr(BooleanLiteralExpr *node);
     Value evaluateVariableExpr(VariableExpr *node);
@@ -44,23 +142,40 @@ private:
     Value evaluateUnaryOpExpr(UnaryOpExpr *node);
     Value evaluateCallExpr(CallExpr *node);
 
-    Value performNumericBinaryOp(const Value &left, const Value &right, TokenType op);
-    Value performBooleanBinaryOp(const Value &left, const Value &right, TokenType op);
+    Value applyBinaryOp(TokenType op, const Value &left, const Value &right);
+    Value applyBinaryOp(BinaryOperator op, const Value &left, const Value &right);
+    Value applySpecializedBinaryOp(BinaryOpExpr *node, const Value &left, const Value &right);
+    Value applyUnaryOp(TokenType op, const Value &right);
     bool convertToBool(const Value &val);
-    void enforceType(const std::string &var_name, DeclaredType declared_type, const Value &assigned_value);
+    void enforceType(std::string_view var_name, DeclaredType declared_type, Value &assigned_value);
+    void enforceReturnType(std::string_view function_name, DeclaredType declared_type, Value &result);
     Value getDefaultValueForType(TokenType type_token);
 
-    void enterScope();
+    void prepare(ProgramNode *ast);
+    void bindFunctions();
+    void materializeFunction(FunctionDeclaration *function);
+    void enterScope(FunctionDeclaration *function);
     void exitScope();
-    std::pair<Value *, DeclaredType *> findVariableInScope(const std::string &name);
+    VariableSlot *findGlobal(std::string_view name);
+    VariableSlot *findGlobal(VariableExpr *var);
+    VariableSlot *findGlobal(Symbol symbol, std::string_view name);
+    VariableSlot *findVariableSlot(VariableExpr *var);
 
 public:
     Evaluator();
     void registerNativeFunction(const std::string &name, NativeFunction func);
+    void registerNativeFunction(const std::string &name, NativeFunctionInfo info);
+    const NativeFunctionInfo *findNativeFunction(std::string_view name) const;
     void registerConstant(const std::string &name, Value value);
+    void setEngine(ExecutionEngine selected_engine);
     void interpret(std::unique_ptr<ProgramNode> ast);
+    std::unique_ptr<CompiledProgram> compile(ProgramNode *ast);
+    bool load(const CompiledProgram &compiled);
+    void run(CompiledProgram &compiled);
     Value callNativeFunctionByName(const std::string &name, const std::vector<Value> &args);
     Value getConstant(const std::string &name);
+    std::string registrationKey() const;
+    ExecutionStats &getStats();
 };
 
 #endif
\ No newline at end of file
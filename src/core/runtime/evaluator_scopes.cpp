@@ -4,29 +4,70 @@
 #include <string>
 #include <utility>
 
-void Evaluator::enterScope()
+void Evaluator::enterScope(FunctionDeclaration *function)
 {
-    scopeStack.emplace_back();
+    frames.push_back({function, localSlots.size()});
+    localSlots.resize(localSlots.size() + function->local_symbols.size());
 }
 
 void Evaluator::exitScope()
 {
-    if (scopeStack.empty())
+    if (frames.empty())
     {
         throw std::runtime_error("Internal error: Attempted to exit empty scope stack.");
     }
-    scopeStack.pop_back();
+    localSlots.resize(frames.back().base);
+    frames.pop_back();
 }
 
-std::pair<Value *, DeclaredType *> Evaluator::findVariableInScope(const std::string &name)
+VariableSlot *Evaluator::findGlobal(std::string_view name)
 {
-    for (auto it = scopeStack.rbegin(); it != scopeStack.rend(); ++it)
+    const uint32_t *slot = globalTable.find(name);
+    if (slot == nullptr || *slot >= globals.size() || !globals[*slot].defined)
     {
-        auto var_it = it->find(name);
-        if (var_it != it->end())
+        return nullptr;
+    }
+    return &globals[*slot];
+}
+
+VariableSlot *Evaluator::findGlobal(VariableExpr *var)
+{
+    return findGlobal(var->symbol, var->name);
+}
+
+VariableSlot *Evaluator::findGlobal(Symbol symbol, std::string_view name)
+{
+    const uint32_t *slot = globalTable.find(symbol, name);
+    if (slot == nullptr || *slot >= globals.size() || !globals[*slot].defined)
+    {
+        return nullptr;
+    }
+    return &globals[*slot];
+}
+
+VariableSlot *Evaluator::findVariableSlot(VariableExpr *var)
+{
+    switch (var->scope)
+    {
+    case VariableScope::GLOBAL:
+        return &globals[var->slot];
+    case VariableScope::LOCAL:
+        return &localSlots[frames.back().base + var->slot];
+    case VariableScope::DYNAMIC:
+        for (auto frame_it = frames.rbegin(); frame_it != frames.rend(); ++frame_it)
         {
-            return {&var_it->second.first, &var_it->second.second};
+            const ArenaSpan<Symbol> &symbols = frame_it->function->local_symbols;
+            for (size_t i = 0; i < symbols.size(); ++i)
+            {
+                VariableSlot &slot = localSlots[frame_it->base + i];
+                if (slot.defined && symbols[i] == var->symbol)
+                {
+                    return &slot;
+                }
+            }
         }
+        return findGlobal(var);
+    default:
+        throw std::runtime_error("Internal error: Variable '" + std::string(var->name) + "' was not resolved before evaluation.");
     }
-    return {nullptr, nullptr};
-}
\ No newline at end of file
+}
@@ -10,18 +10,24 @@ Value Evaluator::evaluateProgramNode(ProgramNode *node)
 {
     for (const auto &stmt : node->statements)
     {
-        evaluate(stmt.get());
+        evaluate(stmt);
+        if (controlFlow == ControlFlow::RETURN)
+        {
+            controlFlow = ControlFlow::NORMAL;
+            throw FunctionReturnException(std::move(returnValue));
+        }
     }
     return std::monostate{};
 }
 
 Value Evaluator::evaluateFunctionDeclaration(FunctionDeclaration *node)
 {
-    if (userFunctions.count(node->name) || nativeFunctions.count(node->name))
+    FunctionEntry &entry = functions[node->function_slot];
+    if (entry.declaration || entry.native)
     {
-        throw std::runtime_error("Runtime error: Function or native function '" + node->name + "' already declared.");
+        throw std::runtime_error("Runtime error: Function or native function '" + std::string(node->name) + "' already declared.");
     }
-    userFunctions[node->name] = node;
+    entry.declaration = node;
     return std::monostate{};
 }
 
@@ -29,13 +35,10 @@ Value Evaluator::evaluateBlockStatement(BlockStatement *node)
 {
     for (const auto &stmt : node->statements)
     {
-        try
-        {
-            evaluate(stmt.get());
-        }
-        catch (const FunctionReturnException &)
+        evaluate(stmt);
+        if (controlFlow != ControlFlow::NORMAL)
         {
-            throw;
+            break;
         }
     }
     return std::monostate{};
@@ -46,58 +49,68 @@ Value Evaluator::evaluateReturnStatement(ReturnStatement *node)
     Value ret_val = std::monostate{};
     if (node->expression)
     {
-        ret_val = evaluate(node->expression.get());
+        ret_val = evaluate(node->expression);
     }
-    throw FunctionReturnException(std::move(ret_val));
+    returnValue = std::move(ret_val);
+    controlFlow = ControlFlow::RETURN;
+    return std::monostate{};
 }
 
 Value Evaluator::evaluateDeclarationStatement(DeclarationStatement *node)
 {
-    std::string var_name = node->target->name;
+    std::string_view var_name = node->target->name;
     DeclaredType declared_type = tokenTypeToDeclaredType(node->declared_type);
 
-    if (scopeStack.back().count(var_name))
+    if (findVariableSlot(node->target)->defined)
     {
-        throw std::runtime_error("Runtime error: Variable '" + var_name + "' already declared in this scope.");
+        throw std::runtime_error("Runtime error: Variable '" + std::string(var_name) + "' already declared in this scope.");
     }
 
     Value initial_value_resolved = std::monostate{};
     if (node->value)
     {
-        initial_value_resolved = evaluate(node->value.get());
+        initial_value_resolved = evaluate(node->value);
     }
     else
     {
         initial_value_resolved = getDefaultValueForType(node->declared_type);
     }
 
-    enforceType(var_name, declared_type, initial_value_resolved);
-    scopeStack.back()[var_name] = {initial_value_resolved, declared_type};
+    if (node->needs_type_check)
+    {
+        enforceType(var_name, declared_type, initial_value_resolved);
+    }
+    *findVariableSlot(node->target) = {initial_value_resolved, declared_type, true};
     return initial_value_resolved;
 }
 
 Value Evaluator::evaluateAssignmentStatement(AssignmentStatement *node)
 {
-    Value value = evaluate(node->value.get());
-    std::string var_name = node->target->name;
-
-    auto [val_ptr, type_ptr] = findVariableInScope(var_name);
+    Value value = evaluate(node->value);
+    VariableSlot *slot = findVariableSlot(node->target);
+    if (slot == nullptr)
+    {
+        slot = &localSlots[frames.back().base + node->target->slot];
+    }
 
-    if (val_ptr == nullptr)
+    if (!slot->defined)
     {
-        scopeStack.back()[var_name] = {value, DeclaredType::ANY};
+        *slot = {value, DeclaredType::ANY, true};
     }
     else
     {
-        enforceType(var_name, *type_ptr, value);
-        *val_ptr = value;
+        if (node->needs_type_check)
+        {
+            enforceType(node->target->name, slot->type, value);
+        }
+        slot->value = value;
     }
     return value;
 }
 
 Value Evaluator::evaluateEchoStatement(EchoStatement *node)
 {
-    Value result = evaluate(node->expression.get());
+    Value result = evaluate(node->expression);
     std::cout << result << std::endl;
     return std::monostate{};
 }
\ No newline at end of file
@@ -27,7 +27,7 @@ throw std::runtime_error("Internal error: convertToBool received unsupported typ
 } }, val);
 }
 
-void Evaluator::enforceType(const std::string &var_name, DeclaredType declared_type, const Value &assigned_value)
+void Evaluator::enforceType(std::string_view var_name, DeclaredType declared_type, Value &assigned_value)
 {
     DeclaredType actual_type = valueTypeToDeclaredType(assigned_value);
 
@@ -62,7 +62,7 @@ void Evaluator::enforceType(const std::string &var_name, DeclaredType declared_t
         }
         break;
     default:
-        throw std::runtime_error("Internal error: Unknown declared type for variable '" + var_name + "'.");
+        throw std::runtime_error("Internal error: Unknown declared type for variable '" + std::string(var_name) + "'.");
     }
 
     if (!type_matches)
@@ -111,21 +111,27 @@ void Evaluator::enforceType(const std::string &var_name, DeclaredType declared_t
         }
         throw std::runtime_error(ss.str());
     }
+
+    if (declared_type == DeclaredType::NUMBER && actual_type == DeclaredType::INTEGER)
+    {
+        assigned_value = static_cast<double>(std::get<long long>(assigned_value));
+    }
+    else if (declared_type == DeclaredType::BOOLEAN && actual_type == DeclaredType::INTEGER)
+    {
+        assigned_value = std::get<long long>(assigned_value) != 0LL;
+    }
 }
 
-Value Evaluator::getDefaultValueForType(TokenType type_token)
+void Evaluator::enforceReturnType(std::string_view function_name, DeclaredType declared_type, Value &result)
 {
-    switch (type_token)
+    if (declared_type == DeclaredType::ANY || valueTypeToDeclaredType(result) == declared_type)
     {
-    case TokenType::STRING_KEYWORD:
-        return std::string("");
-    case TokenType::INTEGER_KEYWORD:
-        return 0LL;
-    case TokenType::NUMBER_KEYWORD:
-        return 0.0;
-    case TokenType::BOOLEAN_KEYWORD:
-        return false;
-    default:
-        return std::monostate{};
+        return;
     }
+    enforceType("function '" + std::string(function_name) + "' return value", declared_type, result);
+}
+
+Value Evaluator::getDefaultValueForType(TokenType type_token)
+{
+    return defaultValueForTypeKeyword(type_token);
 }
\ No newline at end of file
@@ -10,76 +10,95 @@
 
 Value Evaluator::evaluateCallExpr(CallExpr *node)
 {
-    if (auto *callee_var = dynamic_cast<VariableExpr *>(node->callee.get()))
+    if (node->function_slot == CallExpr::UNBOUND)
     {
-        std::string function_name = callee_var->name;
-        auto native_it = nativeFunctions.find(function_name);
-        auto user_it = userFunctions.find(function_name);
+        throw std::runtime_error("Runtime error: Callee in function call is not a simple identifier.");
+    }
 
-        if (native_it != nativeFunctions.end())
+    const FunctionEntry &entry = functions[node->function_slot];
+    if (entry.native)
+    {
+        std::vector<Value> args;
+        args.reserve(node->arguments.size());
+        for (const auto &arg_node : node->arguments)
         {
-            std::vector<Value> args;
-            for (const auto &arg_node : node->arguments)
-            {
-                args.push_back(evaluate(arg_node.get()));
-            }
-            return native_it->second(args);
+            args.push_back(evaluate(arg_node));
         }
-        else if (user_it != userFunctions.end())
-        {
-            FunctionDeclaration *func_decl = user_it->second;
-            enterScope();
-            Value result_val = std::monostate{};
-
-            try
-            {
-                size_t user_arg_idx = 0;
-                for (const auto &param_decl : func_decl->parameters)
-                {
-                    Value param_val;
-                    if (user_arg_idx < node->arguments.size())
-                    {
-                        param_val = evaluate(node->arguments[user_arg_idx].get());
-                    }
-                    else if (param_decl.default_value)
-                    {
-                        param_val = evaluate(param_decl.default_value.get());
-                    }
-                    else
-                    {
-                        throw std::runtime_error("Runtime error: Missing required argument for parameter '" + param_decl.name + "' in function '" + func_decl->name + "'.");
-                    }
-
-                    enforceType(param_decl.name, tokenTypeToDeclaredType(param_decl.declared_type), param_val);
-                    scopeStack.back()[param_decl.name] = {param_val, tokenTypeToDeclaredType(param_decl.declared_type)};
-                    user_arg_idx++;
-                }
+        return entry.native->function(args);
+    }
+    if (!entry.declaration)
+    {
+        throw std::runtime_error("Runtime error: Undefined function '" + functionTable.names[node->function_slot] + "'.");
+    }
 
-                if (user_arg_idx < node->arguments.size())
-                {
-                    throw std::runtime_error("Runtime error: Too many arguments provided for function '" + func_decl->name + "'. Expected " + std::to_string(func_decl->parameters.size()) + ", but got " + std::to_string(node->arguments.size()) + ".");
-                }
+    FunctionDeclaration *func_decl = entry.declaration;
+    if (!func_decl->body)
+    {
+        materializeFunction(func_decl);
+    }
 
-                evaluate(func_decl->body.get());
+    size_t args_base = argumentStack.size();
+    for (const auto &arg_node : node->arguments)
+    {
+        argumentStack.push_back(evaluate(arg_node));
+    }
+    size_t argc = argumentStack.size() - args_base;
 
-                result_val = getDefaultValueForType(func_decl->return_type);
-            }
-            catch (const FunctionReturnException &e)
-            {
-                result_val = e.returnValue;
-            }
+    enterScope(func_decl);
 
-            enforceType("function '" + func_decl->name + "' return value", tokenTypeToDeclaredType(func_decl->return_type), result_val);
-            exitScope();
-            return result_val;
+    const FunctionSignature &signature = func_decl->signature;
+    size_t user_arg_idx = 0;
+    for (const auto &param_decl : func_decl->parameters)
+    {
+        Value param_val;
+        bool needs_check = true;
+        if (user_arg_idx < argc)
+        {
+            param_val = std::move(argumentStack[args_base + user_arg_idx]);
+            needs_check = node->arguments_need_check;
+        }
+        else if (param_decl.default_value)
+        {
+            param_val = evaluate(param_decl.default_value);
+            needs_check = param_decl.default_needs_check;
         }
         else
         {
-            throw std::runtime_error("Runtime error: Undefined function '" + function_name + "'.");
+            throw std::runtime_error("Runtime error: Missing required argument for parameter '" + std::string(param_decl.name) + "' in function '" + std::string(func_decl->name) + "'.");
+        }
+
+        DeclaredType param_type = signature.parameter_types[user_arg_idx];
+        if (needs_check)
+        {
+            enforceType(param_decl.name, param_type, param_val);
         }
+        localSlots[frames.back().base + param_decl.slot] = {std::move(param_val), param_type, true};
+        user_arg_idx++;
+    }
+
+    if (user_arg_idx < argc)
+    {
+        throw std::runtime_error("Runtime error: Too many arguments provided for function '" + std::string(func_decl->name) + "'. Expected " + std::to_string(func_decl->parameters.size()) + ", but got " + std::to_string(argc) + ".");
+    }
+    argumentStack.resize(args_base);
+
+    evaluate(func_decl->body);
+
+    Value result_val;
+    if (controlFlow == ControlFlow::RETURN)
+    {
+        result_val = std::move(returnValue);
+        controlFlow = ControlFlow::NORMAL;
     }
     else
     {
-        throw std::runtime_error("Runtime error: Callee in function call is not a simple identifier.");
+        result_val = getDefaultValueForType(func_decl->return_type);
+    }
+
+    if (func_decl->return_needs_check)
+    {
+        enforceReturnType(func_decl->name, signature.return_type, result_val);
     }
-}
\ No newline at end of file
+    exitScope();
+    return result_val;
+}
@@ -8,6 +8,11 @@
 #include <cmath>
 
 Value Evaluator::evaluateStringLiteralExpr(StringLiteralExpr *node)
+{
+    return std::string(node->value);
+}
+
+Value Evaluator::evaluateIntegerLiteralExpr(IntegerLiteralExpr *node)
 {
     return node->value;
 }
@@ -7,258 +7,504 @@
 #include <sstream>
 #include <cmath>
 #include <limits>
+#include <array>
+#include <utility>
 
-Value Evaluator::performNumericBinaryOp(const Value &left_val, const Value &right_val, TokenType op)
+template <typename T>
+constexpr bool isIntegral = std::is_same_v<T, long long> || std::is_same_v<T, bool>;
+
+template <typename T>
+constexpr bool isNumericLike = isIntegral<T> || std::is_same_v<T, double>;
+
+template <typename T>
+static long long asInteger(const T &value)
 {
-    long long left_ll = 0;
-    bool left_is_ll_candidate = false;
-    if (std::holds_alternative<long long>(left_val))
+    if constexpr (std::is_same_v<T, bool>)
+        return value ? 1LL : 0LL;
+    else
+        return value;
+}
+
+template <typename T>
+static double asDouble(const T &value)
+{
+    if constexpr (std::is_same_v<T, double>)
+        return value;
+    else
+        return static_cast<double>(asInteger(value));
+}
+
+template <typename T>
+static bool isTruthy(const T &value)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+        return !value.empty();
+    else if constexpr (std::is_same_v<T, long long>)
+        return value != 0LL;
+    else if constexpr (std::is_same_v<T, double>)
+        return value != 0.0;
+    else if constexpr (std::is_same_v<T, bool>)
+        return value;
+    else
+        return false;
+}
+
+template <typename T>
+static std::string concatOperand(const T &value)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        return value;
+    }
+    else
+    {
+        std::stringstream ss;
+        if constexpr (std::is_same_v<T, std::monostate>)
+            ss << Value(value);
+        else
+            ss << value;
+        return ss.str();
+    }
+}
+
+template <typename T>
+static long long bitwiseOperand(const T &value, const char *side)
+{
+    if constexpr (std::is_same_v<T, double>)
     {
-        left_ll = std::get<long long>(left_val);
-        left_is_ll_candidate = true;
+        long long ll_val = static_cast<long long>(value);
+        if (value != static_cast<double>(ll_val))
+        {
+            throw std::runtime_error(std::string("Type error: Bitwise OR operator '|' requires integer operands. ") + side + " operand is a non-integer number.");
+        }
+        return ll_val;
     }
-    else if (std::holds_alternative<bool>(left_val))
+    else if constexpr (isIntegral<T>)
     {
-        left_ll = std::get<bool>(left_val) ? 1LL : 0LL;
-        left_is_ll_candidate = true;
+        return asInteger(value);
     }
-    else if (std::holds_alternative<double>(left_val))
+    else
     {
-        left_is_ll_candidate = false;
+        throw std::runtime_error(std::string("Type error: Bitwise OR operator '|' can only be applied to integer or number (convertible to integer) operands. ") + side + " operand is of invalid type.");
     }
+}
 
-    long long right_ll = 0;
-    bool right_is_ll_candidate = false;
-    if (std::holds_alternative<long long>(right_val))
+template <typename L, typename R>
+static bool valuesEqual(const L &left, const R &right)
+{
+    if constexpr (std::is_same_v<L, R>)
     {
-        right_ll = std::get<long long>(right_val);
-        right_is_ll_candidate = true;
+        if constexpr (std::is_same_v<L, double>)
+            return std::abs(left - right) < 0.000001;
+        else if constexpr (std::is_same_v<L, std::monostate>)
+            return true;
+        else
+            return left == right;
     }
-    else if (std::holds_alternative<bool>(right_val))
+    else if constexpr (isNumericLike<L> && isNumericLike<R>)
     {
-        right_ll = std::get<bool>(right_val) ? 1LL : 0LL;
-        right_is_ll_candidate = true;
+        return std::abs(asDouble(left) - asDouble(right)) < 0.000001;
     }
-    else if (std::holds_alternative<double>(right_val))
+    else
     {
-        right_is_ll_candidate = false;
+        return false;
     }
+}
 
-    if (left_is_ll_candidate && right_is_ll_candidate)
+template <BinaryOperator OP, typename L, typename R>
+static Value applyTyped(const L &left, const R &right)
+{
+    if constexpr (OP == BinaryOperator::CONCAT)
     {
-        switch (op)
+        return concatOperand(left) + concatOperand(right);
+    }
+    else if constexpr (OP == BinaryOperator::EQUAL)
+    {
+        return valuesEqual(left, right);
+    }
+    else if constexpr (OP == BinaryOperator::NOT_EQUAL)
+    {
+        return !valuesEqual(left, right);
+    }
+    else if constexpr (OP == BinaryOperator::AND)
+    {
+        return isTruthy(left) && isTruthy(right);
+    }
+    else if constexpr (OP == BinaryOperator::OR)
+    {
+        return isTruthy(left) || isTruthy(right);
+    }
+    else if constexpr (OP == BinaryOperator::BIT_OR)
+    {
+        long long left_int = bitwiseOperand(left, "Left");
+        return left_int | bitwiseOperand(right, "Right");
+    }
+    else if constexpr (!isNumericLike<L> || !isNumericLike<R>)
+    {
+        throw std::runtime_error("Type error: Arithmetic/comparison operators can only be applied to numbers.");
+    }
+    else if constexpr (OP == BinaryOperator::GREATER)
+    {
+        return asDouble(left) > asDouble(right);
+    }
+    else if constexpr (OP == BinaryOperator::GREATER_EQUAL)
+    {
+        return asDouble(left) >= asDouble(right);
+    }
+    else if constexpr (OP == BinaryOperator::LESS)
+    {
+        return asDouble(left) < asDouble(right);
+    }
+    else if constexpr (OP == BinaryOperator::LESS_EQUAL)
+    {
+        return asDouble(left) <= asDouble(right);
+    }
+    else if constexpr (isIntegral<L> && isIntegral<R>)
+    {
+        return integerArithmetic(OP, asInteger(left), asInteger(right));
+    }
+    else
+    {
+        double left_d = asDouble(left);
+        double right_d = asDouble(right);
+        switch (OP)
         {
-        case TokenType::PLUS:
-            return left_ll + right_ll;
-        case TokenType::MINUS:
-            return left_ll - right_ll;
-        case TokenType::STAR:
-            return left_ll * right_ll;
-        case TokenType::SLASH:
-            if (right_ll == 0LL)
-                throw std::runtime_error("Runtime error: Integer division by zero.");
-            return left_ll / right_ll;
+        case BinaryOperator::ADD:
+            return left_d + right_d;
+        case BinaryOperator::SUBTRACT:
+            return left_d - right_d;
+        case BinaryOperator::MULTIPLY:
+            return left_d * right_d;
         default:
-            break;
+            if (right_d == 0.0)
+                throw std::runtime_error("Runtime error: Floating-point division by zero.");
+            return left_d / right_d;
         }
     }
+}
 
-    double left_double_val;
-    if (std::holds_alternative<double>(left_val))
-        left_double_val = std::get<double>(left_val);
-    else
-        left_double_val = static_cast<double>(left_ll);
+Value integerArithmetic(BinaryOperator op, long long left, long long right)
+{
+    long long result;
+    switch (op)
+    {
+    case BinaryOperator::ADD:
+        if (!__builtin_add_overflow(left, right, &result))
+            return result;
+        return static_cast<double>(left) + static_cast<double>(right);
+    case BinaryOperator::SUBTRACT:
+        if (!__builtin_sub_overflow(left, right, &result))
+            return result;
+        return static_cast<double>(left) - static_cast<double>(right);
+    case BinaryOperator::MULTIPLY:
+        if (!__builtin_mul_overflow(left, right, &result))
+            return result;
+        return static_cast<double>(left) * static_cast<double>(right);
+    default:
+        if (right == 0LL)
+            throw std::runtime_error("Runtime error: Integer division by zero.");
+        if (left == std::numeric_limits<long long>::min() && right == -1LL)
+            return -static_cast<double>(left);
+        return left / right;
+    }
+}
 
-    double right_double_val;
-    if (std::holds_alternative<double>(right_val))
-        right_double_val = std::get<double>(right_val);
-    else
-        right_double_val = static_cast<double>(right_ll);
+using BinaryHandler = Value (*)(const Value &left, const Value &right);
+constexpr size_t VALUE_TYPES = std::variant_size_v<Value>;
+using BinaryHandlerTable = std::array<std::array<BinaryHandler, VALUE_TYPES>, VALUE_TYPES>;
+
+template <BinaryOperator OP, size_t L, size_t R>
+static Value dispatchTyped(const Value &left, const Value &right)
+{
+    return applyTyped<OP>(*std::get_if<L>(&left), *std::get_if<R>(&right));
+}
+
+template <BinaryOperator OP, size_t L, size_t... R>
+static constexpr std::array<BinaryHandler, VALUE_TYPES> handlerRow(std::index_sequence<R...>)
+{
+    return {&dispatchTyped<OP, L, R>...};
+}
+
+template <BinaryOperator OP, size_t... L>
+static constexpr BinaryHandlerTable handlerTable(std::index_sequence<L...>)
+{
+    return {handlerRow<OP, L>(std::make_index_sequence<VALUE_TYPES>{})...};
+}
 
+template <size_t... OP>
+static constexpr std::array<BinaryHandlerTable, sizeof...(OP)> dispatchMatrix(std::index_sequence<OP...>)
+{
+    return {handlerTable<static_cast<BinaryOperator>(OP)>(std::make_index_sequence<VALUE_TYPES>{})...};
+}
+
+static constexpr auto binaryDispatch = dispatchMatrix(std::make_index_sequence<static_cast<size_t>(BinaryOperator::COUNT)>{});
+
+BinaryOperator binaryOperatorFor(TokenType op)
+{
     switch (op)
     {
     case TokenType::PLUS:
-        return left_double_val + right_double_val;
+        return BinaryOperator::ADD;
     case TokenType::MINUS:
-        return left_double_val - right_double_val;
+        return BinaryOperator::SUBTRACT;
     case TokenType::STAR:
-        return left_double_val * right_double_val;
+        return BinaryOperator::MULTIPLY;
     case TokenType::SLASH:
-        if (right_double_val == 0.0)
-            throw std::runtime_error("Runtime error: Floating-point division by zero.");
-        return left_double_val / right_double_val;
+        return BinaryOperator::DIVIDE;
     case TokenType::GREATER:
-        return left_double_val > right_double_val;
+        return BinaryOperator::GREATER;
     case TokenType::GREATER_EQUAL:
-        return left_double_val >= right_double_val;
+        return BinaryOperator::GREATER_EQUAL;
     case TokenType::LESS:
-        return left_double_val < right_double_val;
+        return BinaryOperator::LESS;
     case TokenType::LESS_EQUAL:
-        return left_double_val <= right_double_val;
-    default:
-        throw std::runtime_error("Unsupported numeric binary operator.");
-    }
-}
-
-Value Evaluator::performBooleanBinaryOp(const Value &left_val, const Value &right_val, TokenType op)
-{
-    bool left_bool = convertToBool(left_val);
-    bool right_bool = convertToBool(right_val);
-
-    switch (op)
-    {
+        return BinaryOperator::LESS_EQUAL;
+    case TokenType::EQUAL_EQUAL:
+        return BinaryOperator::EQUAL;
+    case TokenType::BANG_EQUAL:
+        return BinaryOperator::NOT_EQUAL;
     case TokenType::AND:
-        return left_bool && right_bool;
+        return BinaryOperator::AND;
     case TokenType::OR:
-        return left_bool || right_bool;
+        return BinaryOperator::OR;
+    case TokenType::PIPE:
+        return BinaryOperator::BIT_OR;
+    case TokenType::DOT:
+        return BinaryOperator::CONCAT;
     default:
-        throw std::runtime_error("Unsupported boolean binary operator.");
+        return BinaryOperator::COUNT;
     }
 }
 
-Value Evaluator::evaluateBinaryOpExpr(BinaryOpExpr *node)
+static BinarySpecialization specializeBinaryOp(TokenType op, const Value &left_val, const Value &right_val)
 {
-    Value left_val = evaluate(node->left.get());
-    Value right_val = evaluate(node->right.get());
-
-    if (node->op == TokenType::DOT)
+    if (left_val.index() != right_val.index())
     {
-        std::string s_left, s_right;
-        std::visit([&](auto &&arg)
-                   {
-using T = std::decay_t<decltype(arg)>;
-if constexpr (std::is_same_v<T, std::string>) {
-s_left = arg;
-} else {
-std::stringstream ss;
-ss << arg;
-s_left = ss.str();
-} }, left_val);
-        std::visit([&](auto &&arg)
-                   {
-using T = std::decay_t<decltype(arg)>;
-if constexpr (std::is_same_v<T, std::string>) {
-s_right = arg;
-} else {
-std::stringstream ss;
-ss << arg;
-s_right = ss.str();
-} }, right_val);
-        return s_left + s_right;
+        return BinarySpecialization::GENERIC;
     }
-    else if (node->op == TokenType::PLUS || node->op == TokenType::MINUS ||
-             node->op == TokenType::STAR || node->op == TokenType::SLASH ||
-             node->op == TokenType::GREATER || node->op == TokenType::GREATER_EQUAL ||
-             node->op == TokenType::LESS || node->op == TokenType::LESS_EQUAL)
-    {
 
-        bool left_is_numeric_like = std::holds_alternative<long long>(left_val) || std::holds_alternative<double>(left_val) || std::holds_alternative<bool>(left_val);
-        bool right_is_numeric_like = std::holds_alternative<long long>(right_val) || std::holds_alternative<double>(right_val) || std::holds_alternative<bool>(right_val);
-
-        if (!left_is_numeric_like || !right_is_numeric_like)
+    if (std::holds_alternative<long long>(left_val))
+    {
+        switch (op)
         {
-            throw std::runtime_error("Type error: Arithmetic/comparison operators can only be applied to numbers.");
+        case TokenType::PLUS:
+            return BinarySpecialization::INTEGER_ADD;
+        case TokenType::MINUS:
+            return BinarySpecialization::INTEGER_SUBTRACT;
+        case TokenType::STAR:
+            return BinarySpecialization::INTEGER_MULTIPLY;
+        case TokenType::SLASH:
+            return BinarySpecialization::INTEGER_DIVIDE;
+        case TokenType::GREATER:
+            return BinarySpecialization::INTEGER_GREATER;
+        case TokenType::GREATER_EQUAL:
+            return BinarySpecialization::INTEGER_GREATER_EQUAL;
+        case TokenType::LESS:
+            return BinarySpecialization::INTEGER_LESS;
+        case TokenType::LESS_EQUAL:
+            return BinarySpecialization::INTEGER_LESS_EQUAL;
+        case TokenType::EQUAL_EQUAL:
+            return BinarySpecialization::INTEGER_EQUAL;
+        case TokenType::BANG_EQUAL:
+            return BinarySpecialization::INTEGER_NOT_EQUAL;
+        default:
+            return BinarySpecialization::GENERIC;
         }
-
-        return performNumericBinaryOp(left_val, right_val, node->op);
     }
-    else if (node->op == TokenType::EQUAL_EQUAL || node->op == TokenType::BANG_EQUAL)
+
+    if (std::holds_alternative<double>(left_val))
     {
+        switch (op)
+        {
+        case TokenType::PLUS:
+            return BinarySpecialization::NUMBER_ADD;
+        case TokenType::MINUS:
+            return BinarySpecialization::NUMBER_SUBTRACT;
+        case TokenType::STAR:
+            return BinarySpecialization::NUMBER_MULTIPLY;
+        case TokenType::SLASH:
+            return BinarySpecialization::NUMBER_DIVIDE;
+        case TokenType::GREATER:
+            return BinarySpecialization::NUMBER_GREATER;
+        case TokenType::GREATER_EQUAL:
+            return BinarySpecialization::NUMBER_GREATER_EQUAL;
+        case TokenType::LESS:
+            return BinarySpecialization::NUMBER_LESS;
+        case TokenType::LESS_EQUAL:
+            return BinarySpecialization::NUMBER_LESS_EQUAL;
+        case TokenType::EQUAL_EQUAL:
+            return BinarySpecialization::NUMBER_EQUAL;
+        case TokenType::BANG_EQUAL:
+            return BinarySpecialization::NUMBER_NOT_EQUAL;
+        default:
+            return BinarySpecialization::GENERIC;
+        }
+    }
 
-        bool are_equal = std::visit([](auto &&l_arg, auto &&r_arg) -> bool
-                                    {
+    if (std::holds_alternative<std::string>(left_val))
+    {
+        switch (op)
+        {
+        case TokenType::DOT:
+            return BinarySpecialization::STRING_CONCAT;
+        case TokenType::EQUAL_EQUAL:
+            return BinarySpecialization::STRING_EQUAL;
+        case TokenType::BANG_EQUAL:
+            return BinarySpecialization::STRING_NOT_EQUAL;
+        default:
+            return BinarySpecialization::GENERIC;
+        }
+    }
 
-using L = std::decay_t<decltype(l_arg)>;
-using R = std::decay_t<decltype(r_arg)>;
+    return BinarySpecialization::GENERIC;
+}
 
-if constexpr (std::is_same_v<L, R>) {
-if constexpr (std::is_same_v<L, std::string>) return l_arg == r_arg;
-else if constexpr (std::is_same_v<L, long long>) return l_arg == r_arg;
-else if constexpr (std::is_same_v<L, double>) return std::abs(l_arg - r_arg) < 0.000001;
-else if constexpr (std::is_same_v<L, bool>) return l_arg == r_arg;
-else if constexpr (std::is_same_v<L, std::monostate>) return true;
+template <typename T>
+static bool bothHold(const Value &left_val, const Value &right_val, T &left, T &right)
+{
+    const T *left_ptr = std::get_if<T>(&left_val);
+    const T *right_ptr = std::get_if<T>(&right_val);
+    if (left_ptr == nullptr || right_ptr == nullptr)
+    {
+        return false;
+    }
+    left = *left_ptr;
+    right = *right_ptr;
+    return true;
 }
 
-else if constexpr (
-(std::is_same_v<L, long long> || std::is_same_v<L, double> || std::is_same_v<L, bool>) &&
-(std::is_same_v<R, long long> || std::is_same_v<R, double> || std::is_same_v<R, bool>)
-) {
-double l_double, r_double;
-if constexpr (std::is_same_v<L, long long>) l_double = static_cast<double>(l_arg);
-else if constexpr (std::is_same_v<L, double>) l_double = l_arg;
-else if constexpr (std::is_same_v<L, bool>) l_double = l_arg ? 1.0 : 0.0;
-else l_double = 0.0;
-
-if constexpr (std::is_same_v<R, long long>) r_double = static_cast<double>(r_arg);
-else if constexpr (std::is_same_v<R, double>) r_double = r_arg;
-else if constexpr (std::is_same_v<R, bool>) r_double = r_arg ? 1.0 : 0.0;
-else r_double = 0.0;
-
-return std::abs(l_double - r_double) < 0.000001;
+Value Evaluator::evaluateBinaryOpExpr(BinaryOpExpr *node)
+{
+    Value left_val = evaluate(node->left);
+    Value right_val = evaluate(node->right);
+    return applySpecializedBinaryOp(node, left_val, right_val);
 }
 
-return false; }, left_val, right_val);
+Value Evaluator::applySpecializedBinaryOp(BinaryOpExpr *node, const Value &left_val, const Value &right_val)
+{
+    long long left_ll;
+    long long right_ll;
+    double left_d;
+    double right_d;
 
-        return (node->op == TokenType::EQUAL_EQUAL) ? are_equal : !are_equal;
-    }
-    else if (node->op == TokenType::AND || node->op == TokenType::OR)
+    switch (node->specialization)
     {
+    case BinarySpecialization::UNINITIALIZED:
+        node->specialization = specializeBinaryOp(node->op, left_val, right_val);
+        return applySpecializedBinaryOp(node, left_val, right_val);
+    case BinarySpecialization::GENERIC:
+        return applyBinaryOp(node->op, left_val, right_val);
 
-        return performBooleanBinaryOp(left_val, right_val, node->op);
-    }
-    else if (node->op == TokenType::PIPE)
+    case BinarySpecialization::INTEGER_ADD:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return integerArithmetic(BinaryOperator::ADD, left_ll, right_ll);
+        break;
+    case BinarySpecialization::INTEGER_SUBTRACT:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return integerArithmetic(BinaryOperator::SUBTRACT, left_ll, right_ll);
+        break;
+    case BinarySpecialization::INTEGER_MULTIPLY:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return integerArithmetic(BinaryOperator::MULTIPLY, left_ll, right_ll);
+        break;
+    case BinarySpecialization::INTEGER_DIVIDE:
+        if (bothHold(left_val, right_val, left_ll, right_ll) && right_ll != 0LL)
+            return integerArithmetic(BinaryOperator::DIVIDE, left_ll, right_ll);
+        break;
+    case BinarySpecialization::INTEGER_GREATER:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return static_cast<double>(left_ll) > static_cast<double>(right_ll);
+        break;
+    case BinarySpecialization::INTEGER_GREATER_EQUAL:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return static_cast<double>(left_ll) >= static_cast<double>(right_ll);
+        break;
+    case BinarySpecialization::INTEGER_LESS:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return static_cast<double>(left_ll) < static_cast<double>(right_ll);
+        break;
+    case BinarySpecialization::INTEGER_LESS_EQUAL:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return static_cast<double>(left_ll) <= static_cast<double>(right_ll);
+        break;
+    case BinarySpecialization::INTEGER_EQUAL:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return left_ll == right_ll;
+        break;
+    case BinarySpecialization::INTEGER_NOT_EQUAL:
+        if (bothHold(left_val, right_val, left_ll, right_ll))
+            return left_ll != right_ll;
+        break;
+
+    case BinarySpecialization::NUMBER_ADD:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return left_d + right_d;
+        break;
+    case BinarySpecialization::NUMBER_SUBTRACT:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return left_d - right_d;
+        break;
+    case BinarySpecialization::NUMBER_MULTIPLY:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return left_d * right_d;
+        break;
+    case BinarySpecialization::NUMBER_DIVIDE:
+        if (bothHold(left_val, right_val, left_d, right_d) && right_d != 0.0)
+            return left_d / right_d;
+        break;
+    case BinarySpecialization::NUMBER_GREATER:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return left_d > right_d;
+        break;
+    case BinarySpecialization::NUMBER_GREATER_EQUAL:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return left_d >= right_d;
+        break;
+    case BinarySpecialization::NUMBER_LESS:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return left_d < right_d;
+        break;
+    case BinarySpecialization::NUMBER_LESS_EQUAL:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return left_d <= right_d;
+        break;
+    case BinarySpecialization::NUMBER_EQUAL:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return std::abs(left_d - right_d) < 0.000001;
+        break;
+    case BinarySpecialization::NUMBER_NOT_EQUAL:
+        if (bothHold(left_val, right_val, left_d, right_d))
+            return !(std::abs(left_d - right_d) < 0.000001);
+        break;
+
+    case BinarySpecialization::STRING_CONCAT:
+    case BinarySpecialization::STRING_EQUAL:
+    case BinarySpecialization::STRING_NOT_EQUAL:
     {
-        long long left_int_val;
-        long long right_int_val;
+        const std::string *left_s = std::get_if<std::string>(&left_val);
+        const std::string *right_s = std::get_if<std::string>(&right_val);
+        if (left_s == nullptr || right_s == nullptr)
+            break;
+        if (node->specialization == BinarySpecialization::STRING_CONCAT)
+            return *left_s + *right_s;
+        return (*left_s == *right_s) == (node->specialization == BinarySpecialization::STRING_EQUAL);
+    }
+    }
 
-        if (std::holds_alternative<long long>(left_val))
-        {
-            left_int_val = std::get<long long>(left_val);
-        }
-        else if (std::holds_alternative<double>(left_val))
-        {
-            double d_val = std::get<double>(left_val);
-            long long ll_val = static_cast<long long>(d_val);
-            if (d_val != static_cast<double>(ll_val))
-            {
-                throw std::runtime_error("Type error: Bitwise OR operator '|' requires integer operands. Left operand is a non-integer number.");
-            }
-            left_int_val = ll_val;
-        }
-        else if (std::holds_alternative<bool>(left_val))
-        {
-            left_int_val = std::get<bool>(left_val) ? 1LL : 0LL;
-        }
-        else
-        {
-            throw std::runtime_error("Type error: Bitwise OR operator '|' can only be applied to integer or number (convertible to integer) operands. Left operand is of invalid type.");
-        }
+    node->specialization = BinarySpecialization::GENERIC;
+    return applyBinaryOp(node->op, left_val, right_val);
+}
 
-        if (std::holds_alternative<long long>(right_val))
-        {
-            right_int_val = std::get<long long>(right_val);
-        }
-        else if (std::holds_alternative<double>(right_val))
-        {
-            double d_val = std::get<double>(right_val);
-            long long ll_val = static_cast<long long>(d_val);
-            if (d_val != static_cast<double>(ll_val))
-            {
-                throw std::runtime_error("Type error: Bitwise OR operator '|' requires integer operands. Right operand is a non-integer number.");
-            }
-            right_int_val = ll_val;
-        }
-        else if (std::holds_alternative<bool>(right_val))
-        {
-            right_int_val = std::get<bool>(right_val) ? 1LL : 0LL;
-        }
-        else
-        {
-            throw std::runtime_error("Type error: Bitwise OR operator '|' can only be applied to integer or number (convertible to integer) operands. Right operand is of invalid type.");
-        }
+Value Evaluator::applyBinaryOp(TokenType op, const Value &left_val, const Value &right_val)
+{
+    return applyBinaryOp(binaryOperatorFor(op), left_val, right_val);
+}
 
-        return left_int_val | right_int_val;
+Value Evaluator::applyBinaryOp(BinaryOperator op, const Value &left_val, const Value &right_val)
+{
+    if (op >= BinaryOperator::COUNT)
+    {
+        throw std::runtime_error("Unsupported binary operator.");
     }
-
-    throw std::runtime_error("Unsupported binary operator.");
-}
\ No newline at end of file
+    return binaryDispatch[static_cast<size_t>(op)][left_val.index()][right_val.index()](left_val, right_val);
+}
@@ -9,15 +9,19 @@
 
 Value Evaluator::evaluateUnaryOpExpr(UnaryOpExpr *node)
 {
-    Value right_val = evaluate(node->right.get());
+    Value right_val = evaluate(node->right);
+    return applyUnaryOp(node->op, right_val);
+}
 
-    if (node->op == TokenType::MINUS)
+Value Evaluator::applyUnaryOp(TokenType op, const Value &right_val)
+{
+    if (op == TokenType::MINUS)
     {
         return std::visit([](auto &&arg) -> Value
                           {
 using T = std::decay_t<decltype(arg)>;
 if constexpr (std::is_same_v<T, long long>) {
-return -arg;
+return integerArithmetic(BinaryOperator::SUBTRACT, 0LL, arg);
 } else if constexpr (std::is_same_v<T, double>) {
 return -arg;
 } else if constexpr (std::is_same_v<T, bool>) {
@@ -26,7 +30,7 @@ return static_cast<long long>(arg ? -1 : 0);
 throw std::runtime_error("Type error: Unary '-' operator can only be applied to numbers.");
 } }, right_val);
     }
-    else if (node->op == TokenType::BANG || node->op == TokenType::NOT)
+    else if (op == TokenType::BANG || op == TokenType::NOT)
     {
         return !convertToBool(right_val);
     }
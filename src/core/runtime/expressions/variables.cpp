@@ -7,15 +7,67 @@
 #include <sstream>
 #include <cmath>
 
+static ReadSpecialization specializeRead(VariableScope scope, const Value &value)
+{
+    if (scope != VariableScope::LOCAL && scope != VariableScope::GLOBAL)
+    {
+        return ReadSpecialization::GENERIC;
+    }
+
+    bool local = scope == VariableScope::LOCAL;
+    if (std::holds_alternative<long long>(value))
+    {
+        return local ? ReadSpecialization::LOCAL_INTEGER : ReadSpecialization::GLOBAL_INTEGER;
+    }
+    if (std::holds_alternative<double>(value))
+    {
+        return local ? ReadSpecialization::LOCAL_NUMBER : ReadSpecialization::GLOBAL_NUMBER;
+    }
+    if (std::holds_alternative<bool>(value))
+    {
+        return local ? ReadSpecialization::LOCAL_BOOLEAN : ReadSpecialization::GLOBAL_BOOLEAN;
+    }
+    return ReadSpecialization::GENERIC;
+}
+
 Value Evaluator::evaluateVariableExpr(VariableExpr *node)
 {
-    auto [val_ptr, type_ptr] = findVariableInScope(node->name);
-    if (val_ptr != nullptr)
+    switch (node->specialization)
     {
-        return *val_ptr;
+    case ReadSpecialization::LOCAL_INTEGER:
+        if (const long long *value = std::get_if<long long>(&localSlots[frames.back().base + node->slot].value))
+            return *value;
+        break;
+    case ReadSpecialization::LOCAL_NUMBER:
+        if (const double *value = std::get_if<double>(&localSlots[frames.back().base + node->slot].value))
+            return *value;
+        break;
+    case ReadSpecialization::LOCAL_BOOLEAN:
+        if (const bool *value = std::get_if<bool>(&localSlots[frames.back().base + node->slot].value))
+            return *value;
+        break;
+    case ReadSpecialization::GLOBAL_INTEGER:
+        if (const long long *value = std::get_if<long long>(&globals[node->slot].value))
+            return *value;
+        break;
+    case ReadSpecialization::GLOBAL_NUMBER:
+        if (const double *value = std::get_if<double>(&globals[node->slot].value))
+            return *value;
+        break;
+    case ReadSpecialization::GLOBAL_BOOLEAN:
+        if (const bool *value = std::get_if<bool>(&globals[node->slot].value))
+            return *value;
+        break;
+    default:
+        break;
     }
-    else
+
+    VariableSlot *slot = findVariableSlot(node);
+    if (slot == nullptr || !slot->defined)
     {
-        throw std::runtime_error("Undefined variable: " + node->name);
+        throw std::runtime_error("Undefined variable: " + std::string(node->name));
     }
+
+    node->specialization = node->specialization == ReadSpecialization::UNINITIALIZED ? specializeRead(node->scope, slot->value) : ReadSpecialization::GENERIC;
+    return slot->value;
 }
\ No newline at end of file
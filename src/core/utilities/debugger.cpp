@@ -1,6 +1,7 @@
 #include "debugger.h"
 #include <iostream>
 #include <string>
+#include <iomanip>
 #include "../common/token.h"
 
 #ifdef ENABLE_DEBUG_OUTPUT
@@ -32,16 +33,21 @@ void debug_print_ast_node(const ASTNode *node, int indent)
 
     printIndent(indent);
 
-    if (auto *prog = dynamic_cast<const ProgramNode *>(node))
+    switch (node->kind)
     {
+    case NodeKind::PROGRAM:
+    {
+        const auto *prog = static_cast<const ProgramNode *>(node);
         std::cout << "ProgramNode (" << prog->statements.size() << " statements)\n";
         for (const auto &stmt : prog->statements)
         {
-            debug_print_ast_node(stmt.get(), indent + 1);
+            debug_print_ast_node(stmt, indent + 1);
         }
+        break;
     }
-    else if (auto *funcDecl = dynamic_cast<const FunctionDeclaration *>(node))
+    case NodeKind::FUNCTION_DECLARATION:
     {
+        const auto *funcDecl = static_cast<const FunctionDeclaration *>(node);
         std::cout << "FunctionDeclaration (Name: " << funcDecl->name
                   << ", ReturnType: " << Token(funcDecl->return_type, "", 0).toString() << ")\n";
         printIndent(indent + 1);
@@ -54,100 +60,136 @@ void debug_print_ast_node(const ASTNode *node, int indent)
             {
                 printIndent(indent + 3);
                 std::cout << "Default Value:\n";
-                debug_print_ast_node(param.default_value.get(), indent + 4);
+                debug_print_ast_node(param.default_value, indent + 4);
             }
         }
         printIndent(indent + 1);
         std::cout << "Body:\n";
-        debug_print_ast_node(funcDecl->body.get(), indent + 2);
+        if (!funcDecl->body)
+        {
+            printIndent(indent + 2);
+            std::cout << "(deferred, " << funcDecl->deferred_body.size() << " bytes)\n";
+        }
+        debug_print_ast_node(funcDecl->body, indent + 2);
+        break;
     }
-    else if (auto *block = dynamic_cast<const BlockStatement *>(node))
+    case NodeKind::BLOCK_STATEMENT:
     {
+        const auto *block = static_cast<const BlockStatement *>(node);
         std::cout << "BlockStatement (" << block->statements.size() << " statements)\n";
         for (const auto &stmt : block->statements)
         {
-            debug_print_ast_node(stmt.get(), indent + 1);
+            debug_print_ast_node(stmt, indent + 1);
         }
+        break;
     }
-    else if (auto *ret = dynamic_cast<const ReturnStatement *>(node))
+    case NodeKind::RETURN_STATEMENT:
     {
+        const auto *ret = static_cast<const ReturnStatement *>(node);
         std::cout << "ReturnStatement\n";
         if (ret->expression)
         {
-            debug_print_ast_node(ret->expression.get(), indent + 1);
+            debug_print_ast_node(ret->expression, indent + 1);
         }
         else
         {
             printIndent(indent + 1);
             std::cout << "No Return Value\n";
         }
+        break;
     }
-    else if (auto *decl = dynamic_cast<const DeclarationStatement *>(node))
+    case NodeKind::DECLARATION_STATEMENT:
     {
+        const auto *decl = static_cast<const DeclarationStatement *>(node);
         std::cout << "DeclarationStatement (Type: " << Token(decl->declared_type, "", 0).toString() << ", Target: " << decl->target->name << ")\n";
         if (decl->value)
         {
-            debug_print_ast_node(decl->value.get(), indent + 1);
+            debug_print_ast_node(decl->value, indent + 1);
         }
         else
         {
             printIndent(indent + 1);
             std::cout << "Initial Value: None\n";
         }
+        break;
     }
-    else if (auto *assign = dynamic_cast<const AssignmentStatement *>(node))
+    case NodeKind::ASSIGNMENT_STATEMENT:
     {
+        const auto *assign = static_cast<const AssignmentStatement *>(node);
         std::cout << "AssignmentStatement (Target: " << assign->target->name << ")\n";
-        debug_print_ast_node(assign->value.get(), indent + 1);
+        debug_print_ast_node(assign->value, indent + 1);
+        break;
     }
-    else if (auto *echo = dynamic_cast<const EchoStatement *>(node))
+    case NodeKind::ECHO_STATEMENT:
     {
+        const auto *echo = static_cast<const EchoStatement *>(node);
         std::cout << "EchoStatement\n";
-        debug_print_ast_node(echo->expression.get(), indent + 1);
+        debug_print_ast_node(echo->expression, indent + 1);
+        break;
     }
-    else if (auto *strLit = dynamic_cast<const StringLiteralExpr *>(node))
+    case NodeKind::STRING_LITERAL:
     {
+        const auto *strLit = static_cast<const StringLiteralExpr *>(node);
         std::cout << "StringLiteralExpr: \"" << strLit->value << "\"\n";
+        break;
     }
-    else if (auto *numLit = dynamic_cast<const NumberLiteralExpr *>(node))
+    case NodeKind::INTEGER_LITERAL:
     {
+        const auto *intLit = static_cast<const IntegerLiteralExpr *>(node);
+        std::cout << "IntegerLiteralExpr: " << intLit->value << "\n";
+        break;
+    }
+    case NodeKind::NUMBER_LITERAL:
+    {
+        const auto *numLit = static_cast<const NumberLiteralExpr *>(node);
         std::cout << "NumberLiteralExpr: " << numLit->value << "\n";
+        break;
     }
-    else if (auto *boolLit = dynamic_cast<const BooleanLiteralExpr *>(node))
+    case NodeKind::BOOLEAN_LITERAL:
     {
+        const auto *boolLit = static_cast<const BooleanLiteralExpr *>(node);
         std::cout << "BooleanLiteralExpr: " << (boolLit->value ? "true" : "false") << "\n";
+        break;
     }
-    else if (auto *var = dynamic_cast<const VariableExpr *>(node))
+    case NodeKind::VARIABLE:
     {
+        const auto *var = static_cast<const VariableExpr *>(node);
         std::cout << "VariableExpr: " << var->name << "\n";
+        break;
     }
-    else if (auto *binOp = dynamic_cast<const BinaryOpExpr *>(node))
+    case NodeKind::BINARY_OP:
     {
+        const auto *binOp = static_cast<const BinaryOpExpr *>(node);
         std::cout << "BinaryOpExpr (Op: " << Token(binOp->op, "", 0).toString() << ")\n";
-        debug_print_ast_node(binOp->left.get(), indent + 1);
-        debug_print_ast_node(binOp->right.get(), indent + 1);
+        debug_print_ast_node(binOp->left, indent + 1);
+        debug_print_ast_node(binOp->right, indent + 1);
+        break;
     }
-    else if (auto *unaryOp = dynamic_cast<const UnaryOpExpr *>(node))
+    case NodeKind::UNARY_OP:
     {
+        const auto *unaryOp = static_cast<const UnaryOpExpr *>(node);
         std::cout << "UnaryOpExpr (Op: " << Token(unaryOp->op, "", 0).toString() << ")\n";
-        debug_print_ast_node(unaryOp->right.get(), indent + 1);
+        debug_print_ast_node(unaryOp->right, indent + 1);
+        break;
     }
-    else if (auto *call = dynamic_cast<const CallExpr *>(node))
+    case NodeKind::CALL:
     {
+        const auto *call = static_cast<const CallExpr *>(node);
         std::cout << "CallExpr\n";
         printIndent(indent + 1);
         std::cout << "Callee:\n";
-        debug_print_ast_node(call->callee.get(), indent + 2);
+        debug_print_ast_node(call->callee, indent + 2);
         printIndent(indent + 1);
         std::cout << "Arguments (" << call->arguments.size() << "):\n";
         for (const auto &arg : call->arguments)
         {
-            debug_print_ast_node(arg.get(), indent + 2);
+            debug_print_ast_node(arg, indent + 2);
         }
+        break;
     }
-    else
-    {
+    default:
         std::cout << "Unknown AST Node Type\n";
+        break;
     }
 }
 
@@ -156,4 +198,174 @@ void debug_print_ast_footer()
     std::cout << "----------------------------------\n\n";
 }
 
+static const char *opCodeName(OpCode op)
+{
+    switch (op)
+    {
+    case OpCode::CONSTANT:
+        return "CONSTANT";
+    case OpCode::POP:
+        return "POP";
+    case OpCode::GET_GLOBAL:
+        return "GET_GLOBAL";
+    case OpCode::SET_GLOBAL:
+        return "SET_GLOBAL";
+    case OpCode::SET_GLOBAL_UNCHECKED:
+        return "SET_GLOBAL_UNCHECKED";
+    case OpCode::DECLARE_GLOBAL:
+        return "DECLARE_GLOBAL";
+    case OpCode::DECLARE_GLOBAL_UNCHECKED:
+        return "DECLARE_GLOBAL_UNCHECKED";
+    case OpCode::GET_LOCAL:
+        return "GET_LOCAL";
+    case OpCode::SET_LOCAL:
+        return "SET_LOCAL";
+    case OpCode::SET_LOCAL_UNCHECKED:
+        return "SET_LOCAL_UNCHECKED";
+    case OpCode::DECLARE_LOCAL:
+        return "DECLARE_LOCAL";
+    case OpCode::DECLARE_LOCAL_UNCHECKED:
+        return "DECLARE_LOCAL_UNCHECKED";
+    case OpCode::GET_DYNAMIC:
+        return "GET_DYNAMIC";
+    case OpCode::SET_DYNAMIC:
+        return "SET_DYNAMIC";
+    case OpCode::ADD:
+        return "ADD";
+    case OpCode::SUBTRACT:
+        return "SUBTRACT";
+    case OpCode::MULTIPLY:
+        return "MULTIPLY";
+    case OpCode::DIVIDE:
+        return "DIVIDE";
+    case OpCode::GREATER:
+        return "GREATER";
+    case OpCode::GREATER_EQUAL:
+        return "GREATER_EQUAL";
+    case OpCode::LESS:
+        return "LESS";
+    case OpCode::LESS_EQUAL:
+        return "LESS_EQUAL";
+    case OpCode::EQUAL:
+        return "EQUAL";
+    case OpCode::NOT_EQUAL:
+        return "NOT_EQUAL";
+    case OpCode::AND:
+        return "AND";
+    case OpCode::OR:
+        return "OR";
+    case OpCode::BIT_OR:
+        return "BIT_OR";
+    case OpCode::CONCAT:
+        return "CONCAT";
+    case OpCode::NEGATE:
+        return "NEGATE";
+    case OpCode::NOT:
+        return "NOT";
+    case OpCode::ECHO:
+        return "ECHO";
+    case OpCode::CALL:
+        return "CALL";
+    case OpCode::CALL_UNCHECKED:
+        return "CALL_UNCHECKED";
+    case OpCode::DEFINE_FUNCTION:
+        return "DEFINE_FUNCTION";
+    case OpCode::PARAM:
+        return "PARAM";
+    case OpCode::BIND_DEFAULT:
+        return "BIND_DEFAULT";
+    case OpCode::RETURN:
+        return "RETURN";
+    case OpCode::RUNTIME_ERROR:
+        return "RUNTIME_ERROR";
+    case OpCode::HALT:
+        return "HALT";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static void debug_print_chunk(const std::string &title, const Chunk &chunk)
+{
+    std::cout << "== " << title << " ==\n";
+    size_t offset = 0;
+    while (offset < chunk.code.size())
+    {
+        OpCode op = static_cast<OpCode>(chunk.code[offset]);
+        const uint8_t *operands = chunk.code.data() + offset + 1;
+        std::cout << std::setw(6) << offset << "  " << opCodeName(op);
+
+        switch (op)
+        {
+        case OpCode::CONSTANT:
+        case OpCode::RUNTIME_ERROR:
+            std::cout << " " << chunk.constants[readU32(operands)];
+            offset += 5;
+            break;
+        case OpCode::GET_DYNAMIC:
+            std::cout << " " << chunk.names[readU32(operands)];
+            offset += 5;
+            break;
+        case OpCode::SET_DYNAMIC:
+            std::cout << " " << chunk.names[readU32(operands)] << " l" << readU16(operands + 4);
+            offset += 7;
+            break;
+        case OpCode::GET_GLOBAL:
+        case OpCode::SET_GLOBAL:
+        case OpCode::SET_GLOBAL_UNCHECKED:
+            std::cout << " g" << readU32(operands);
+            offset += 5;
+            break;
+        case OpCode::DECLARE_GLOBAL:
+        case OpCode::DECLARE_GLOBAL_UNCHECKED:
+            std::cout << " g" << readU32(operands) << " " << static_cast<int>(operands[4]);
+            offset += 6;
+            break;
+        case OpCode::GET_LOCAL:
+        case OpCode::SET_LOCAL:
+        case OpCode::SET_LOCAL_UNCHECKED:
+            std::cout << " l" << readU16(operands);
+            offset += 3;
+            break;
+        case OpCode::DECLARE_LOCAL:
+        case OpCode::DECLARE_LOCAL_UNCHECKED:
+            std::cout << " l" << readU16(operands) << " " << static_cast<int>(operands[2]);
+            offset += 4;
+            break;
+        case OpCode::CALL:
+        case OpCode::CALL_UNCHECKED:
+            std::cout << " f" << readU32(operands) << " " << static_cast<int>(operands[4]);
+            offset += 6;
+            break;
+        case OpCode::DEFINE_FUNCTION:
+            std::cout << " #" << readU32(operands);
+            offset += 5;
+            break;
+        case OpCode::PARAM:
+            std::cout << " " << static_cast<int>(operands[0]) << " skip " << readU16(operands + 1);
+            offset += 4;
+            break;
+        case OpCode::BIND_DEFAULT:
+            std::cout << " " << static_cast<int>(operands[0]);
+            offset += 2;
+            break;
+        default:
+            offset += 1;
+            break;
+        }
+        std::cout << "\n";
+    }
+}
+
+void debug_print_bytecode(const CompiledProgram &program)
+{
+    std::cout << "\n--- Bytecode ---" << std::endl;
+    debug_print_chunk("<main>", program.main);
+    for (size_t i = 0; i < program.functions.size(); ++i)
+    {
+        debug_print_chunk("#" + std::to_string(i) + " " + program.functions[i]->name, program.functions[i]->chunk);
+    }
+    std::cout << "----------------------------------\n\n";
+}
+
 #endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <string>
 #include <memory>
 #include "../parser/ast.h"
+#include "../compiler/bytecode.h"
 
 #ifdef ENABLE_DEBUG_OUTPUT
 
@@ -11,6 +12,7 @@ void debug_print_message(const std::string &msg);
 void debug_print_ast_header(const std::string &title);
 void debug_print_ast_node(const ASTNode *node, int indent = 0);
 void debug_print_ast_footer();
+void debug_print_bytecode(const CompiledProgram &program);
 
 #else
 
@@ -18,6 +20,7 @@ inline void debug_print_message(const std::string &msg) {}
 inline void debug_print_ast_header(const std::string &title) {}
 inline void debug_print_ast_node(const ASTNode *node, int indent = 0) {}
 inline void debug_print_ast_footer() {}
+inline void debug_print_bytecode(const CompiledProgram &) {}
 
 #endif
 
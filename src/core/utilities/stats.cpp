@@ -0,0 +1,38 @@
+#include "stats.h"
+#include <iostream>
+#include <iomanip>
+#include <sys/resource.h>
+
+long peak_rss_kb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+void print_execution_stats(const std::string &filename, const ExecutionStats &stats)
+{
+    std::ios::fmtflags flags = std::cerr.flags();
+    std::streamsize precision = std::cerr.precision();
+    std::cerr << std::fixed << std::setprecision(3)
+              << "--- Stats for " << filename << " ---\n"
+              << "  parse:   " << stats.parse_ms << " ms (peak rss " << stats.parse_peak_rss_kb / 1024.0 << " MB)\n"
+              << "  compile: " << stats.compile_ms << " ms\n"
+              << "  execute: " << stats.execute_ms << " ms\n"
+              << "  peak rss: " << peak_rss_kb() / 1024.0 << " MB\n";
+    if (stats.type_checks > 0)
+    {
+        std::cerr << std::setprecision(1)
+                  << "  types:   " << stats.type_checks_elided << " of " << stats.type_checks << " checks elided ("
+                  << 100.0 * stats.type_checks_elided / stats.type_checks << "%)\n";
+    }
+    if (!stats.cache.empty())
+    {
+        std::cerr << "  cache:   " << stats.cache << "\n";
+    }
+    std::cerr.flags(flags);
+    std::cerr.precision(precision);
+}
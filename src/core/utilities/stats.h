@@ -0,0 +1,27 @@
+#ifndef MCL_STATS_H
+#define MCL_STATS_H
+
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+struct ExecutionStats
+{
+    double parse_ms = 0.0;
+    double compile_ms = 0.0;
+    double execute_ms = 0.0;
+    long parse_peak_rss_kb = 0;
+    size_t type_checks = 0;
+    size_t type_checks_elided = 0;
+    std::string cache;
+};
+
+inline double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+long peak_rss_kb();
+void print_execution_stats(const std::string &filename, const ExecutionStats &stats);
+
+#endif
@@ -0,0 +1,358 @@
+#include "vm.h"
+#include "../compiler/compiler.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+VM::VM(Evaluator &evaluator) : evaluator(evaluator)
+{
+    stack.reserve(256);
+    locals.reserve(256);
+}
+
+Value VM::pop()
+{
+    Value value = std::move(stack.back());
+    stack.pop_back();
+    return value;
+}
+
+void VM::bindParameter(const CallFrame &frame, const ParameterProto &param, Value value, bool check)
+{
+    if (check)
+    {
+        evaluator.enforceType(param.name, param.declared_type, value);
+    }
+    locals[frame.locals_base + param.slot] = {std::move(value), param.declared_type, true};
+}
+
+VariableSlot *VM::findDynamic(Symbol symbol, const std::string &name)
+{
+    for (auto frame_it = frames.rbegin(); frame_it != frames.rend(); ++frame_it)
+    {
+        if (frame_it->function == nullptr)
+        {
+            continue;
+        }
+        const std::vector<Symbol> &symbols = frame_it->function->local_symbols;
+        for (size_t i = 0; i < symbols.size(); ++i)
+        {
+            VariableSlot &slot = locals[frame_it->locals_base + i];
+            if (slot.defined && symbols[i] == symbol)
+            {
+                return &slot;
+            }
+        }
+    }
+    return evaluator.findGlobal(symbol, name);
+}
+
+void VM::declare(VariableSlot &slot, const std::string &name, DeclaredType declared_type, bool check)
+{
+    if (slot.defined)
+    {
+        throw std::runtime_error("Runtime error: Variable '" + name + "' already declared in this scope.");
+    }
+    if (check)
+    {
+        evaluator.enforceType(name, declared_type, stack.back());
+    }
+    slot = {pop(), declared_type, true};
+}
+
+void VM::assign(VariableSlot &slot, const std::string &name, bool check)
+{
+    if (!slot.defined)
+    {
+        slot = {pop(), DeclaredType::ANY, true};
+    }
+    else
+    {
+        if (check)
+        {
+            evaluator.enforceType(name, slot.type, stack.back());
+        }
+        slot.value = pop();
+    }
+}
+
+void VM::callFunction(uint32_t function_slot, uint8_t argc, bool check_arguments, CallFrame *&frame)
+{
+    if (const NativeFunctionInfo *native = evaluator.functions[function_slot].native)
+    {
+        std::vector<Value> args(std::make_move_iterator(stack.end() - argc), std::make_move_iterator(stack.end()));
+        stack.resize(stack.size() - argc);
+        stack.push_back(native->function(args));
+        return;
+    }
+
+    FunctionProto *function = functions[function_slot];
+    if (function == nullptr)
+    {
+        throw std::runtime_error("Runtime error: Undefined function '" + evaluator.functionTable.names[function_slot] + "'.");
+    }
+    if (function->deferred)
+    {
+        evaluator.materializeFunction(function->deferred);
+        Compiler compiler(evaluator.program->symbols);
+        compiler.compileFunctionBody(function->deferred, function);
+        functions.resize(evaluator.functions.size(), nullptr);
+    }
+
+    if (argc > function->parameters.size())
+    {
+        throw std::runtime_error("Runtime error: Too many arguments provided for function '" + function->name + "'. Expected " + std::to_string(function->parameters.size()) + ", but got " + std::to_string(argc) + ".");
+    }
+
+    size_t locals_base = locals.size();
+    locals.resize(locals_base + function->local_names.size());
+    frames.push_back({function, &function->chunk, function->chunk.code.data(), stack.size() - argc, locals_base, argc, check_arguments});
+    frame = &frames.back();
+}
+
+void VM::run(CompiledProgram &program)
+{
+    functions.assign(evaluator.functions.size(), nullptr);
+    frames.push_back({nullptr, &program.main, program.main.code.data(), 0, 0, 0, true});
+    std::vector<VariableSlot> &globals = evaluator.globals;
+    const std::vector<std::string> &global_names = evaluator.globalTable.names;
+    CallFrame *frame = &frames.back();
+    const uint8_t *ip = frame->ip;
+
+    auto binary = [this](BinaryOperator op)
+    {
+        Value right = pop();
+        Value &left = stack.back();
+        left = evaluator.applyBinaryOp(op, left, right);
+    };
+
+    while (true)
+    {
+        switch (static_cast<OpCode>(*ip++))
+        {
+        case OpCode::CONSTANT:
+            stack.push_back(frame->chunk->constants[readU32(ip)]);
+            ip += 4;
+            break;
+        case OpCode::POP:
+            stack.pop_back();
+            break;
+
+        case OpCode::GET_GLOBAL:
+        {
+            uint32_t slot = readU32(ip);
+            ip += 4;
+            if (!globals[slot].defined)
+            {
+                throw std::runtime_error("Undefined variable: " + global_names[slot]);
+            }
+            stack.push_back(globals[slot].value);
+            break;
+        }
+        case OpCode::SET_GLOBAL:
+        case OpCode::SET_GLOBAL_UNCHECKED:
+        {
+            bool check = ip[-1] == static_cast<uint8_t>(OpCode::SET_GLOBAL);
+            uint32_t slot = readU32(ip);
+            ip += 4;
+            assign(globals[slot], global_names[slot], check);
+            break;
+        }
+        case OpCode::DECLARE_GLOBAL:
+        case OpCode::DECLARE_GLOBAL_UNCHECKED:
+        {
+            bool check = ip[-1] == static_cast<uint8_t>(OpCode::DECLARE_GLOBAL);
+            uint32_t slot = readU32(ip);
+            DeclaredType declared_type = static_cast<DeclaredType>(ip[4]);
+            ip += 5;
+            declare(globals[slot], global_names[slot], declared_type, check);
+            break;
+        }
+        case OpCode::GET_LOCAL:
+        {
+            uint16_t slot = readU16(ip);
+            ip += 2;
+            const VariableSlot &local = locals[frame->locals_base + slot];
+            if (!local.defined)
+            {
+                throw std::runtime_error("Undefined variable: " + frame->function->local_names[slot]);
+            }
+            stack.push_back(local.value);
+            break;
+        }
+        case OpCode::SET_LOCAL:
+        case OpCode::SET_LOCAL_UNCHECKED:
+        {
+            bool check = ip[-1] == static_cast<uint8_t>(OpCode::SET_LOCAL);
+            uint16_t slot = readU16(ip);
+            ip += 2;
+            assign(locals[frame->locals_base + slot], frame->function->local_names[slot], check);
+            break;
+        }
+        case OpCode::DECLARE_LOCAL:
+        case OpCode::DECLARE_LOCAL_UNCHECKED:
+        {
+            bool check = ip[-1] == static_cast<uint8_t>(OpCode::DECLARE_LOCAL);
+            uint16_t slot = readU16(ip);
+            DeclaredType declared_type = static_cast<DeclaredType>(ip[2]);
+            ip += 3;
+            declare(locals[frame->locals_base + slot], frame->function->local_names[slot], declared_type, check);
+            break;
+        }
+        case OpCode::GET_DYNAMIC:
+        {
+            uint32_t name_index = readU32(ip);
+            ip += 4;
+            VariableSlot *slot = findDynamic(frame->chunk->name_symbols[name_index], frame->chunk->names[name_index]);
+            if (slot == nullptr)
+            {
+                throw std::runtime_error("Undefined variable: " + frame->chunk->names[name_index]);
+            }
+            stack.push_back(slot->value);
+            break;
+        }
+        case OpCode::SET_DYNAMIC:
+        {
+            uint32_t name_index = readU32(ip);
+            uint16_t fallback = readU16(ip + 4);
+            ip += 6;
+            const std::string &name = frame->chunk->names[name_index];
+            VariableSlot *slot = findDynamic(frame->chunk->name_symbols[name_index], name);
+            assign(slot ? *slot : locals[frame->locals_base + fallback], name, true);
+            break;
+        }
+
+        case OpCode::ADD:
+            binary(BinaryOperator::ADD);
+            break;
+        case OpCode::SUBTRACT:
+            binary(BinaryOperator::SUBTRACT);
+            break;
+        case OpCode::MULTIPLY:
+            binary(BinaryOperator::MULTIPLY);
+            break;
+        case OpCode::DIVIDE:
+            binary(BinaryOperator::DIVIDE);
+            break;
+        case OpCode::GREATER:
+            binary(BinaryOperator::GREATER);
+            break;
+        case OpCode::GREATER_EQUAL:
+            binary(BinaryOperator::GREATER_EQUAL);
+            break;
+        case OpCode::LESS:
+            binary(BinaryOperator::LESS);
+            break;
+        case OpCode::LESS_EQUAL:
+            binary(BinaryOperator::LESS_EQUAL);
+            break;
+        case OpCode::EQUAL:
+            binary(BinaryOperator::EQUAL);
+            break;
+        case OpCode::NOT_EQUAL:
+            binary(BinaryOperator::NOT_EQUAL);
+            break;
+        case OpCode::AND:
+            binary(BinaryOperator::AND);
+            break;
+        case OpCode::OR:
+            binary(BinaryOperator::OR);
+            break;
+        case OpCode::BIT_OR:
+            binary(BinaryOperator::BIT_OR);
+            break;
+        case OpCode::CONCAT:
+            binary(BinaryOperator::CONCAT);
+            break;
+
+        case OpCode::NEGATE:
+            stack.back() = evaluator.applyUnaryOp(TokenType::MINUS, stack.back());
+            break;
+        case OpCode::NOT:
+            stack.back() = evaluator.applyUnaryOp(TokenType::BANG, stack.back());
+            break;
+
+        case OpCode::ECHO:
+            std::cout << stack.back() << std::endl;
+            stack.pop_back();
+            break;
+
+        case OpCode::CALL:
+        case OpCode::CALL_UNCHECKED:
+        {
+            bool check_arguments = ip[-1] == static_cast<uint8_t>(OpCode::CALL);
+            uint32_t function_slot = readU32(ip);
+            uint8_t argc = ip[4];
+            ip += 5;
+            frame->ip = ip;
+            callFunction(function_slot, argc, check_arguments, frame);
+            ip = frame->ip;
+            break;
+        }
+        case OpCode::DEFINE_FUNCTION:
+        {
+            FunctionProto *function = program.functions[readU32(ip)].get();
+            ip += 4;
+            if (functions[function->slot] || evaluator.functions[function->slot].native)
+            {
+                throw std::runtime_error("Runtime error: Function or native function '" + function->name + "' already declared.");
+            }
+            functions[function->slot] = function;
+            break;
+        }
+        case OpCode::PARAM:
+        {
+            uint8_t index = ip[0];
+            uint16_t skip = readU16(ip + 1);
+            ip += 3;
+            const ParameterProto &param = frame->function->parameters[index];
+            if (index < frame->argc)
+            {
+                bindParameter(*frame, param, stack[frame->base + index], frame->check_arguments);
+                ip += skip;
+            }
+            else if (!param.has_default)
+            {
+                throw std::runtime_error("Runtime error: Missing required argument for parameter '" + param.name + "' in function '" + frame->function->name + "'.");
+            }
+            break;
+        }
+        case OpCode::BIND_DEFAULT:
+        {
+            const ParameterProto &param = frame->function->parameters[*ip++];
+            bindParameter(*frame, param, pop(), param.check_default);
+            break;
+        }
+        case OpCode::RETURN:
+        {
+            Value result = pop();
+            if (frame->function == nullptr)
+            {
+                throw FunctionReturnException(std::move(result));
+            }
+
+            if (frame->function->check_return)
+            {
+                evaluator.enforceReturnType(frame->function->name, frame->function->return_type, result);
+            }
+            locals.resize(frame->locals_base);
+            stack.resize(frame->base);
+            stack.push_back(std::move(result));
+
+            frames.pop_back();
+            frame = &frames.back();
+            ip = frame->ip;
+            break;
+        }
+
+        case OpCode::RUNTIME_ERROR:
+            throw std::runtime_error(std::get<std::string>(frame->chunk->constants[readU32(ip)]));
+        case OpCode::HALT:
+            frames.clear();
+            return;
+        default:
+            throw std::runtime_error("Internal error: Unknown opcode in bytecode.");
+        }
+    }
+}
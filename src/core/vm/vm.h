@@ -0,0 +1,43 @@
+#ifndef VM_H
+#define VM_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "../compiler/bytecode.h"
+#include "../runtime/evaluator.h"
+
+struct CallFrame
+{
+    const FunctionProto *function;
+    const Chunk *chunk;
+    const uint8_t *ip;
+    size_t base;
+    size_t locals_base;
+    size_t argc;
+    bool check_arguments;
+};
+
+class VM
+{
+private:
+    Evaluator &evaluator;
+    std::vector<Value> stack;
+    std::vector<VariableSlot> locals;
+    std::vector<CallFrame> frames;
+    std::vector<FunctionProto *> functions;
+
+    Value pop();
+    void bindParameter(const CallFrame &frame, const ParameterProto &param, Value value, bool check);
+    VariableSlot *findDynamic(Symbol symbol, const std::string &name);
+    void declare(VariableSlot &slot, const std::string &name, DeclaredType declared_type, bool check);
+    void assign(VariableSlot &slot, const std::string &name, bool check);
+    void callFunction(uint32_t function_slot, uint8_t argc, bool check_arguments, CallFrame *&frame);
+
+public:
+    VM(Evaluator &evaluator);
+
+    void run(CompiledProgram &program);
+};
+
+#endif
@@ -28,5 +28,5 @@ Value mcl_abs(const std::vector<Value> &args)
 
 void register_abs_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("abs", mcl_abs);
+    eval.registerNativeFunction("abs", NativeFunctionInfo{mcl_abs, true, 1, 1, {DeclaredType::NUMBER}, NativeCost::CONSTANT});
 }
\ No newline at end of file
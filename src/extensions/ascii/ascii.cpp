@@ -50,5 +50,5 @@ return static_cast<long long>(static_cast<unsigned char>(input_string[0]));
 
 void register_ascii_extension(Evaluator &eval)
 {
-eval.registerNativeFunction("ascii", mcl_ascii);
+eval.registerNativeFunction("ascii", NativeFunctionInfo{mcl_ascii, true, 1, 1, {DeclaredType::STRING}, NativeCost::CONSTANT});
 }
\ No newline at end of file
@@ -28,5 +28,5 @@ Value mcl_ceiling(const std::vector<Value> &args)
 
 void register_ceiling_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("ceiling", mcl_ceiling);
+    eval.registerNativeFunction("ceiling", NativeFunctionInfo{mcl_ceiling, true, 1, 1, {DeclaredType::NUMBER}, NativeCost::CONSTANT});
 }
\ No newline at end of file
@@ -61,5 +61,5 @@ return std::string(1, static_cast<char>(ascii_val));
 
 void register_character_extension(Evaluator &eval)
 {
-eval.registerNativeFunction("character", mcl_character);
+eval.registerNativeFunction("character", NativeFunctionInfo{mcl_character, true, 1, 1, {DeclaredType::INTEGER}, NativeCost::CONSTANT});
 }
\ No newline at end of file
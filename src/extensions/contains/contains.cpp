@@ -73,5 +73,5 @@ Value mcl_contains(const std::vector<Value> &args)
 
 void register_contains_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("contains", mcl_contains);
+    eval.registerNativeFunction("contains", NativeFunctionInfo{mcl_contains, true, 2, 2, {DeclaredType::STRING, DeclaredType::STRING}, NativeCost::LINEAR});
 }
\ No newline at end of file
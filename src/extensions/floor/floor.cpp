@@ -28,5 +28,5 @@ Value mcl_floor(const std::vector<Value> &args)
 
 void register_floor_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("floor", mcl_floor);
+    eval.registerNativeFunction("floor", NativeFunctionInfo{mcl_floor, true, 1, 1, {DeclaredType::NUMBER}, NativeCost::CONSTANT});
 }
\ No newline at end of file
@@ -97,5 +97,5 @@ Value mcl_max(const std::vector<Value> &args)
 
 void register_max_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("max", mcl_max);
+    eval.registerNativeFunction("max", NativeFunctionInfo{mcl_max, true, 1, NativeFunctionInfo::VARIADIC, {DeclaredType::NUMBER}, NativeCost::LINEAR});
 }
\ No newline at end of file
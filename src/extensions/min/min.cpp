@@ -97,5 +97,5 @@ Value mcl_min(const std::vector<Value> &args)
 
 void register_min_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("min", mcl_min);
+    eval.registerNativeFunction("min", NativeFunctionInfo{mcl_min, true, 1, NativeFunctionInfo::VARIADIC, {DeclaredType::NUMBER}, NativeCost::LINEAR});
 }
\ No newline at end of file
@@ -183,5 +183,5 @@ Value mcl_pad(const std::vector<Value> &args)
 
 void register_pad_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("pad", mcl_pad);
+    eval.registerNativeFunction("pad", NativeFunctionInfo{mcl_pad, true, 2, 4, {DeclaredType::STRING, DeclaredType::INTEGER, DeclaredType::STRING, DeclaredType::INTEGER}, NativeCost::UNBOUNDED});
 }
\ No newline at end of file
@@ -87,5 +87,5 @@ Value mcl_pi(const std::vector<Value> &args)
 
 void register_pi_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("pi", mcl_pi);
+    eval.registerNativeFunction("pi", NativeFunctionInfo{mcl_pi, true, 0, 1, {DeclaredType::INTEGER}, NativeCost::CONSTANT});
 }
\ No newline at end of file
@@ -51,5 +51,5 @@ Value mcl_reverse(const std::vector<Value> &args)
 
 void register_reverse_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("reverse", mcl_reverse);
+    eval.registerNativeFunction("reverse", NativeFunctionInfo{mcl_reverse, true, 1, NativeFunctionInfo::VARIADIC, {DeclaredType::STRING}, NativeCost::LINEAR});
 }
\ No newline at end of file
@@ -34,5 +34,5 @@ Value mcl_sqrt(const std::vector<Value> &args)
 
 void register_sqrt_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("sqrt", mcl_sqrt);
+    eval.registerNativeFunction("sqrt", NativeFunctionInfo{mcl_sqrt, true, 1, 1, {DeclaredType::NUMBER}, NativeCost::CONSTANT});
 }
\ No newline at end of file
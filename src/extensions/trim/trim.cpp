@@ -173,5 +173,5 @@ Value mcl_trim(const std::vector<Value> &args)
 
 void register_trim_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("trim", mcl_trim);
+    eval.registerNativeFunction("trim", NativeFunctionInfo{mcl_trim, true, 1, 3, {DeclaredType::STRING, DeclaredType::STRING, DeclaredType::INTEGER}, NativeCost::LINEAR});
 }
\ No newline at end of file
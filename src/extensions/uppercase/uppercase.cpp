@@ -205,5 +205,5 @@ Value mcl_uppercase(const std::vector<Value> &args)
 
 void register_uppercase_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("uppercase", mcl_uppercase);
+    eval.registerNativeFunction("uppercase", NativeFunctionInfo{mcl_uppercase, true, 1, 2, {DeclaredType::STRING, DeclaredType::INTEGER}, NativeCost::LINEAR});
 }
\ No newline at end of file
@@ -94,5 +94,5 @@ Value mcl_wrap(const std::vector<Value> &args)
 
 void register_wrap_extension(Evaluator &eval)
 {
-    eval.registerNativeFunction("wrap", mcl_wrap);
+    eval.registerNativeFunction("wrap", NativeFunctionInfo{mcl_wrap, true, 1, 2, {DeclaredType::STRING, DeclaredType::STRING}, NativeCost::LINEAR});
 }
\ No newline at end of file
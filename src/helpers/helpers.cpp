@@ -233,82 +233,110 @@ void registerAllHelpers(Evaluator &eval)
 
     for (const auto &h_def : helper_defs)
     {
-        eval.registerNativeFunction(h_def.helper_name,
-                                    [&eval, h_def](const std::vector<Value> &user_args) -> Value
+        const NativeFunctionInfo *extension = eval.findNativeFunction(h_def.extension_name);
+
+        NativeFunctionInfo info;
+        info.pure = extension != nullptr && extension->pure;
+        info.cost = extension != nullptr ? extension->cost : NativeCost::UNBOUNDED;
+        for (const auto &param_def : h_def.parameters)
+        {
+            if (param_def.kind == ParameterKind::REQUIRED)
+            {
+                info.min_arity++;
+                info.parameter_types.push_back(param_def.expected_type);
+            }
+            else if (param_def.kind == ParameterKind::OPTIONAL)
+            {
+                info.parameter_types.push_back(DeclaredType::ANY);
+            }
+        }
+        info.max_arity = info.parameter_types.size();
+        info.definition = h_def.extension_name;
+        for (const auto &param_def : h_def.parameters)
+        {
+            info.definition += " " + std::to_string(static_cast<int>(param_def.kind)) + ":" + std::to_string(static_cast<int>(param_def.expected_type)) + ":" + param_def.config_value_str;
+        }
+
+        info.function = [&eval, h_def, extension](const std::vector<Value> &user_args) -> Value
+                    {
+                        std::vector<Value> extension_args;
+                        size_t user_arg_idx = 0;
+                        size_t required_count = 0;
+                        size_t optional_count = 0;
+
+                        for (const auto &param_def : h_def.parameters)
+                        {
+                            if (param_def.kind == ParameterKind::REQUIRED)
+                            {
+                                required_count++;
+                            }
+                            else if (param_def.kind == ParameterKind::OPTIONAL)
+                            {
+                                optional_count++;
+                            }
+                        }
+
+                        if (user_args.size() < required_count || user_args.size() > (required_count + optional_count))
+                        {
+                            std::stringstream ss;
+                            ss << "Helper '" << h_def.helper_name << "' expects between " << required_count << " and " << (required_count + optional_count) << " arguments, but received " << user_args.size() << ".";
+                            throw std::runtime_error(ss.str());
+                        }
+
+                        for (const auto &param_def : h_def.parameters)
+                        {
+                            if (param_def.kind == ParameterKind::REQUIRED)
+                            {
+                                if (user_arg_idx >= user_args.size())
+                                {
+                                    throw std::runtime_error("Internal error: Missing required argument for helper '" + h_def.helper_name + "'.");
+                                }
+                                if (param_def.expected_type == DeclaredType::STRING)
+                                {
+                                    extension_args.push_back(get_string_arg(user_args, user_arg_idx, h_def.helper_name, "user_arg_" + std::to_string(user_arg_idx + 1)));
+                                }
+                                else if (param_def.expected_type == DeclaredType::INTEGER)
+                                {
+                                    extension_args.push_back(get_integer_arg(user_args, user_arg_idx, h_def.helper_name, "user_arg_" + std::to_string(user_arg_idx + 1)));
+                                }
+                                else if (param_def.expected_type == DeclaredType::NUMBER)
+                                {
+                                    extension_args.push_back(get_number_arg(user_args, user_arg_idx, h_def.helper_name, "user_arg_" + std::to_string(user_arg_idx + 1)));
+                                }
+                                else if (param_def.expected_type == DeclaredType::BOOLEAN)
+                                {
+                                    if (!std::holds_alternative<bool>(user_args[user_arg_idx]))
                                     {
-                                        std::vector<Value> extension_args;
-                                        size_t user_arg_idx = 0;
-                                        size_t required_count = 0;
-                                        size_t optional_count = 0;
-
-                                        for (const auto &param_def : h_def.parameters)
-                                        {
-                                            if (param_def.kind == ParameterKind::REQUIRED)
-                                            {
-                                                required_count++;
-                                            }
-                                            else if (param_def.kind == ParameterKind::OPTIONAL)
-                                            {
-                                                optional_count++;
-                                            }
-                                        }
-
-                                        if (user_args.size() < required_count || user_args.size() > (required_count + optional_count))
-                                        {
-                                            std::stringstream ss;
-                                            ss << "Helper '" << h_def.helper_name << "' expects between " << required_count << " and " << (required_count + optional_count) << " arguments, but received " << user_args.size() << ".";
-                                            throw std::runtime_error(ss.str());
-                                        }
-
-                                        for (const auto &param_def : h_def.parameters)
-                                        {
-                                            if (param_def.kind == ParameterKind::REQUIRED)
-                                            {
-                                                if (user_arg_idx >= user_args.size())
-                                                {
-                                                    throw std::runtime_error("Internal error: Missing required argument for helper '" + h_def.helper_name + "'.");
-                                                }
-                                                if (param_def.expected_type == DeclaredType::STRING)
-                                                {
-                                                    extension_args.push_back(get_string_arg(user_args, user_arg_idx, h_def.helper_name, "user_arg_" + std::to_string(user_arg_idx + 1)));
-                                                }
-                                                else if (param_def.expected_type == DeclaredType::INTEGER)
-                                                {
-                                                    extension_args.push_back(get_integer_arg(user_args, user_arg_idx, h_def.helper_name, "user_arg_" + std::to_string(user_arg_idx + 1)));
-                                                }
-                                                else if (param_def.expected_type == DeclaredType::NUMBER)
-                                                {
-                                                    extension_args.push_back(get_number_arg(user_args, user_arg_idx, h_def.helper_name, "user_arg_" + std::to_string(user_arg_idx + 1)));
-                                                }
-                                                else if (param_def.expected_type == DeclaredType::BOOLEAN)
-                                                {
-                                                    if (!std::holds_alternative<bool>(user_args[user_arg_idx]))
-                                                    {
-                                                        throw std::runtime_error("Helper '" + h_def.helper_name + "': Argument " + std::to_string(user_arg_idx + 1) + " must be a boolean.");
-                                                    }
-                                                    extension_args.push_back(user_args[user_arg_idx]);
-                                                }
-                                                user_arg_idx++;
-                                            }
-                                            else if (param_def.kind == ParameterKind::OPTIONAL)
-                                            {
-                                                if (user_arg_idx < user_args.size())
-                                                {
-                                                    extension_args.push_back(user_args[user_arg_idx]);
-                                                    user_arg_idx++;
-                                                }
-                                                else
-                                                {
-                                                    extension_args.push_back(param_def.resolved_value);
-                                                }
-                                            }
-                                            else
-                                            {
-                                                extension_args.push_back(param_def.resolved_value);
-                                            }
-                                        }
-
-                                        return eval.callNativeFunctionByName(h_def.extension_name, extension_args);
-                                    });
+                                        throw std::runtime_error("Helper '" + h_def.helper_name + "': Argument " + std::to_string(user_arg_idx + 1) + " must be a boolean.");
+                                    }
+                                    extension_args.push_back(user_args[user_arg_idx]);
+                                }
+                                user_arg_idx++;
+                            }
+                            else if (param_def.kind == ParameterKind::OPTIONAL)
+                            {
+                                if (user_arg_idx < user_args.size())
+                                {
+                                    extension_args.push_back(user_args[user_arg_idx]);
+                                    user_arg_idx++;
+                                }
+                                else
+                                {
+                                    extension_args.push_back(param_def.resolved_value);
+                                }
+                            }
+                            else
+                            {
+                                extension_args.push_back(param_def.resolved_value);
+                            }
+                        }
+
+                        if (extension)
+                        {
+                            return extension->function(extension_args);
+                        }
+                        return eval.callNativeFunctionByName(h_def.extension_name, extension_args);
+                    };
+        eval.registerNativeFunction(h_def.helper_name, std::move(info));
     }
 }
\ No newline at end of file
@@ -1,72 +1,106 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <memory>
 #include <exception>
 #include <vector>
 #include <filesystem>
 #include <regex>
+#include <chrono>
+#include <thread>
 
 #include "core/lexer/lexer.h"
+#include "core/lexer/token_buffer.h"
+#include "core/lexer/token_ring.h"
+#include "core/lexer/parallel_lexer.h"
 #include "core/parser/parser.h"
 #include "core/parser/ast.h"
+#include "core/compiler/program_cache.h"
 #include "core/common/token.h"
+#include "core/common/source_buffer.h"
 #include "core/runtime/evaluator.h"
 #include "core/common/constants.h"
 #include "core/utilities/debugger.h"
+#include "core/utilities/stats.h"
 #include "extensions/extensions.h"
 #include "helpers/helpers.h"
 
 namespace fs = std::filesystem;
 
-int process_single_file(const std::string &filename)
+enum class LexerMode
 {
-    debug_print_message("Processing file: '" + filename + "'...");
+    AUTO,
+    STREAM,
+    BUFFERED,
+    THREADED,
+    PARALLEL
+};
 
-    std::string source_code;
-    std::ifstream file(filename);
-    if (file.is_open())
-    {
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        source_code = buffer.str();
-        file.close();
-    }
-    else
-    {
-        std::cerr << "Error: Could not open file '" << filename << "'. Skipping.\n";
-        return 1;
-    }
+constexpr size_t THREADED_LEXER_MIN_BYTES = 4 * 1024 * 1024;
+constexpr unsigned PARALLEL_LEXER_MIN_THREADS = 4;
 
-    Lexer lexer(source_code);
-    Parser parser(lexer);
+struct RunOptions
+{
+    ExecutionEngine engine = ExecutionEngine::VM;
+    LexerMode lexer = LexerMode::AUTO;
+    bool lazy_functions = false;
+    bool cache = false;
+    std::string cache_dir;
+    bool print_stats = false;
+};
 
-    debug_print_message("Parsing file: '" + filename + "'...");
+std::unique_ptr<ProgramNode> parse_source(std::string_view text, const RunOptions &options)
+{
+    auto parse = [&options](Parser &parser)
+    {
+        parser.setLazyFunctionBodies(options.lazy_functions);
+        return parser.parseProgram();
+    };
 
-    std::unique_ptr<ProgramNode> ast;
-    try
+    LexerMode mode = options.lexer;
+    unsigned threads = std::thread::hardware_concurrency();
+    if (mode == LexerMode::AUTO)
     {
-        ast = parser.parseProgram();
-        debug_print_message("Parsing finished for '" + filename + "'.");
+        mode = LexerMode::STREAM;
+        if (text.size() >= THREADED_LEXER_MIN_BYTES && threads >= PARALLEL_LEXER_MIN_THREADS)
+        {
+            mode = LexerMode::PARALLEL;
+        }
+        else if (text.size() >= THREADED_LEXER_MIN_BYTES && threads > 1)
+        {
+            mode = LexerMode::THREADED;
+        }
     }
-    catch (const std::runtime_error &e)
+
+    if (mode == LexerMode::PARALLEL)
     {
-        std::cerr << "Parser/Lexer Error in '" << filename << "': " << e.what() << std::endl;
-        return 1;
+        TokenBuffer tokens(text);
+        ParallelLexer lexer(text, threads);
+        lexer.fill(tokens);
+        Parser parser(tokens);
+        return parse(parser);
     }
-    catch (const std::exception &e)
+
+    if (mode == LexerMode::THREADED)
     {
-        std::cerr << "An unexpected error occurred during parsing '" << filename << "': " << e.what() << std::endl;
-        return 1;
+        TokenRing ring(text);
+        Parser parser(ring);
+        return parse(parser);
     }
 
-    debug_print_ast_header("Abstract Syntax Tree (AST) for " + filename);
-    debug_print_ast_node(ast.get());
-    debug_print_ast_footer();
+    Lexer lexer(text);
+    if (mode == LexerMode::BUFFERED)
+    {
+        TokenBuffer tokens(text);
+        tokens.fill(lexer);
+        Parser parser(tokens);
+        return parse(parser);
+    }
 
-    debug_print_message("Starting interpretation for '" + filename + "'...");
-    Evaluator evaluator;
+    Parser parser(lexer);
+    return parse(parser);
+}
 
+void register_builtins(Evaluator &evaluator)
+{
     evaluator.registerConstant("MCL_PAD_RIGHT", (long long)MCL_PAD_RIGHT);
     evaluator.registerConstant("MCL_PAD_LEFT", (long long)MCL_PAD_LEFT);
     evaluator.registerConstant("MCL_PAD_STRING_DEFAULT", MCL_PAD_STRING_DEFAULT);
@@ -93,10 +127,103 @@ int process_single_file(const std::string &filename)
 
     registerAllExtensions(evaluator);
     registerAllHelpers(evaluator);
+}
+
+std::unique_ptr<ProgramNode> parse_file(const std::string &filename, std::unique_ptr<SourceBuffer> &source, const RunOptions &options)
+{
+    debug_print_message("Parsing file: '" + filename + "'...");
+
+    std::unique_ptr<ProgramNode> ast;
+    try
+    {
+        ast = parse_source(source->text(), options);
+        debug_print_message("Parsing finished for '" + filename + "'.");
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Parser/Lexer Error in '" << filename << "': " << e.what() << std::endl;
+        return nullptr;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "An unexpected error occurred during parsing '" << filename << "': " << e.what() << std::endl;
+        return nullptr;
+    }
+
+    ast->source = std::move(source);
+
+    debug_print_ast_header("Abstract Syntax Tree (AST) for " + filename);
+    debug_print_ast_node(ast.get());
+    debug_print_ast_footer();
+    return ast;
+}
+
+int process_single_file(const std::string &filename, const RunOptions &options)
+{
+    debug_print_message("Processing file: '" + filename + "'...");
+
+    std::unique_ptr<SourceBuffer> source = SourceBuffer::open(filename);
+    if (!source)
+    {
+        std::cerr << "Error: Could not open file '" << filename << "'. Skipping.\n";
+        return 1;
+    }
+
+    std::unique_ptr<ProgramCache> cache;
+    std::unique_ptr<CompiledProgram> compiled;
+    std::unique_ptr<ProgramNode> ast;
+    Evaluator evaluator;
+    evaluator.setEngine(options.engine);
+    register_builtins(evaluator);
+
+    auto parse_start = std::chrono::steady_clock::now();
+    if (options.cache && options.engine == ExecutionEngine::VM)
+    {
+        cache = std::make_unique<ProgramCache>(filename, source->text(), evaluator.registrationKey(), options.cache_dir);
+        compiled = cache->load();
+    }
+    if (!compiled && !(ast = parse_file(filename, source, options)))
+    {
+        return 1;
+    }
+    double parse_ms = elapsed_ms(parse_start);
+    long parse_peak_rss_kb = peak_rss_kb();
+
+    debug_print_message("Starting interpretation for '" + filename + "'...");
+    if (compiled && !evaluator.load(*compiled))
+    {
+        compiled.reset();
+        if (!(ast = parse_file(filename, source, options)))
+        {
+            return 1;
+        }
+    }
+    evaluator.getStats().parse_ms = parse_ms;
+    evaluator.getStats().parse_peak_rss_kb = parse_peak_rss_kb;
+    if (cache)
+    {
+        evaluator.getStats().cache = (compiled ? "hit " : "miss ") + cache->path();
+    }
 
     try
     {
-        evaluator.interpret(std::move(ast));
+        if (!compiled && cache)
+        {
+            compiled = evaluator.compile(ast.get());
+            if (!cache->store(*compiled))
+            {
+                evaluator.getStats().cache += " (not stored)";
+            }
+        }
+
+        if (compiled)
+        {
+            evaluator.run(*compiled);
+        }
+        else
+        {
+            evaluator.interpret(std::move(ast));
+        }
         debug_print_message("Interpretation finished successfully for '" + filename + "'.");
     }
     catch (const std::runtime_error &e)
@@ -110,6 +237,11 @@ int process_single_file(const std::string &filename)
         return 1;
     }
 
+    if (options.print_stats)
+    {
+        print_execution_stats(filename, evaluator.getStats());
+    }
+
     debug_print_message("Finished processing '" + filename + "'.");
     return 0;
 }
@@ -180,17 +312,74 @@ int main(int argc, char *argv[])
     debug_print_message("MCL starting (Lexer + Parser + Evaluator)...");
 
     std::vector<std::string> files_to_run;
+    std::vector<std::string> patterns;
+    RunOptions options;
     int overall_exit_code = 0;
 
-    if (argc == 1)
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--engine=ast")
+        {
+            options.engine = ExecutionEngine::AST;
+        }
+        else if (arg == "--engine=vm")
+        {
+            options.engine = ExecutionEngine::VM;
+        }
+        else if (arg == "--lexer=stream")
+        {
+            options.lexer = LexerMode::STREAM;
+        }
+        else if (arg == "--lexer=buffered")
+        {
+            options.lexer = LexerMode::BUFFERED;
+        }
+        else if (arg == "--lexer=threaded")
+        {
+            options.lexer = LexerMode::THREADED;
+        }
+        else if (arg == "--lexer=parallel")
+        {
+            options.lexer = LexerMode::PARALLEL;
+        }
+        else if (arg == "--lazy-functions")
+        {
+            options.lazy_functions = true;
+        }
+        else if (arg == "--cache")
+        {
+            options.cache = true;
+        }
+        else if (arg.rfind("--cache-dir=", 0) == 0 && arg.size() > 12)
+        {
+            options.cache = true;
+            options.cache_dir = arg.substr(12);
+        }
+        else if (arg == "--stats")
+        {
+            options.print_stats = true;
+        }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            std::cerr << "Error: Unknown option '" << arg << "'. Supported options: --engine=ast, --engine=vm, --lexer=stream, --lexer=buffered, --lexer=threaded, --lexer=parallel, --lazy-functions, --cache, --cache-dir=<dir>, --stats." << std::endl;
+            return 1;
+        }
+        else
+        {
+            patterns.push_back(arg);
+        }
+    }
+
+    if (patterns.empty())
     {
         files_to_run.push_back("main.nv");
     }
     else
     {
-        for (int i = 1; i < argc; ++i)
+        for (const std::string &pattern : patterns)
         {
-            std::vector<std::string> matched_files = get_files_from_pattern(argv[i]);
+            std::vector<std::string> matched_files = get_files_from_pattern(pattern);
             files_to_run.insert(files_to_run.end(), matched_files.begin(), matched_files.end());
         }
     }
@@ -203,7 +392,7 @@ int main(int argc, char *argv[])
 
     for (const std::string &filename : files_to_run)
     {
-        int file_exit_code = process_single_file(filename);
+        int file_exit_code = process_single_file(filename, options);
         if (file_exit_code != 0)
         {
             overall_exit_code = 1;